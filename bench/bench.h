@@ -0,0 +1,103 @@
+
+#ifndef __BENCH_BENCH_H__
+#define __BENCH_BENCH_H__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+
+namespace bench
+{
+    /**
+    * \brief Benchmark run duration per measurement.
+    */
+    inline std::chrono::milliseconds & duration(
+        void)
+    {
+        static std::chrono::milliseconds d(200);
+        return d;
+    }
+
+    /**
+    * \brief Thread counts to measure: 1, 2, 4... up to hardware concurrency.
+    */
+    inline std::vector<size_t> thread_counts(
+        void)
+    {
+        size_t hw = (std::max)(std::thread::hardware_concurrency(), 1U);
+        std::vector<size_t> counts;
+        for (size_t n = 1U; n < hw; n *= 2U)
+        {
+            counts.push_back(n);
+        }
+        counts.push_back(hw);
+        return counts;
+    }
+
+    /**
+    * \brief Call target operation in a loop on p_threads threads for duration().
+    * Operation receives the calling thread index.
+    * Return total operations per second.
+    */
+    template<
+        class TOp>
+    double throughput(
+        size_t p_threads,
+        TOp p_op)
+    {
+        std::atomic<bool>       start(false);
+        std::atomic<bool>       stop(false);
+        std::atomic<size_t>     total(0);
+
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < p_threads; ++i)
+        {
+            threads.emplace_back([&, i]()
+            {
+                while (!start.load())
+                {
+                    std::this_thread::yield();
+                }
+                size_t ops = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    for (size_t j = 0; j < 64U; ++j)
+                    {
+                        p_op(i);
+                    }
+                    ops += 64U;
+                }
+                total.fetch_add(ops);
+            });
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        start.store(true);
+        std::this_thread::sleep_for(duration());
+        stop.store(true);
+        for (auto & t : threads)
+        {
+            t.join();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        return static_cast<double>(total.load()) / elapsed.count();
+    }
+
+    /**
+    * \brief Print one measurement.
+    */
+    inline void report(
+        char const * p_name,
+        size_t p_threads,
+        double p_ops)
+    {
+        std::printf("%-48s %3zu threads %14.0f ops/s\n", p_name, p_threads, p_ops);
+    }
+
+} // namespace bench
+
+#endif // __BENCH_BENCH_H__
@@ -0,0 +1,72 @@
+
+// Main header.
+#include "cc_sync_ptr_contention.h"
+
+#include "bench.h"
+
+#include "cc/sync_ptr.h"
+
+
+namespace
+{
+    static constexpr size_t slots_per_thread = 64U;
+
+    struct Obj
+    {
+        size_t value_;
+        Obj(size_t p_value = 0) : value_(p_value) {}
+    };
+
+    /**
+    * \brief Pointees recycled and never freed, each thread publishes its own range,
+    * so the published pointer always differs from the current one.
+    */
+    Obj * next_obj(
+        size_t p_index)
+    {
+        static Obj pool[1024U * slots_per_thread];
+        static thread_local size_t n = 0;
+        return &pool[(p_index % 1024U) * slots_per_thread + (++n % slots_per_thread)];
+    }
+
+} // namespace
+
+
+void bench::cc_sync_ptr_contention_writes(void)
+{
+    typedef cc::sync_ptr<Obj, mem::noop_deleter> sync_ptr_t;
+
+    static Obj first;
+
+    for (auto threads : thread_counts())
+    {
+        {
+            sync_ptr_t ptr(&first);
+            auto ops = throughput(threads, [&ptr](size_t p_index)
+            {
+                auto * obj = next_obj(p_index);
+                while (!ptr.reset(obj))
+                {}
+            });
+            report("cc::sync_ptr reset() spin retry", threads, ops);
+        }
+        {
+            sync_ptr_t ptr(&first);
+            auto ops = throughput(threads, [&ptr](size_t p_index)
+            {
+                auto * obj = next_obj(p_index);
+                while (!ptr.reset(obj, cc::exponential_backoff()))
+                {}
+            });
+            report("cc::sync_ptr reset(exponential_backoff)", threads, ops);
+        }
+        {
+            sync_ptr_t ptr(&first);
+            auto ops = throughput(threads, [&ptr](size_t p_index)
+            {
+                ptr.reset(cc::wait_free, next_obj(p_index));
+            });
+            report("cc::sync_ptr reset(wait_free)", threads, ops);
+        }
+    }
+}
@@ -0,0 +1,20 @@
+
+#ifndef __BENCH_CC_SYNC_PTR_CONTENTION_H__
+#define __BENCH_CC_SYNC_PTR_CONTENTION_H__
+
+#ifndef __CC_SYNC_PTR_CONTENTION_H__
+#include "cc/sync_ptr_contention.h"
+#endif
+
+
+namespace bench
+{
+    /**
+    * \brief Concurrent writers on one chain.
+    * Compares a spinning reset() retry loop, exponential backoff and the wait-free reset.
+    */
+    void cc_sync_ptr_contention_writes(void);
+
+} // namespace bench
+
+#endif // __BENCH_CC_SYNC_PTR_CONTENTION_H__
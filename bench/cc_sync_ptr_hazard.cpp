@@ -0,0 +1,79 @@
+
+// Main header.
+#include "cc_sync_ptr_hazard.h"
+
+#include "bench.h"
+
+
+namespace
+{
+    struct Obj
+    {
+        std::atomic<size_t> value_;
+        Obj(size_t p_value = 0) : value_(p_value) {}
+    };
+
+    /**
+    * \brief Reset target chain until stopped.
+    */
+    template<
+        class TSyncPtr,
+        class TMake>
+    std::thread start_writer(
+        TSyncPtr & p_ptr,
+        std::atomic<bool> & p_stop,
+        TMake p_make)
+    {
+        return std::thread([&p_ptr, &p_stop, p_make]()
+        {
+            size_t i = 0;
+            while (!p_stop.load(std::memory_order_relaxed))
+            {
+                auto * obj = p_make(++i);
+                while (!p_ptr.reset(obj))
+                {}
+            }
+        });
+    }
+
+} // namespace
+
+
+void bench::cc_sync_ptr_hazard_reads(void)
+{
+    for (auto threads : thread_counts())
+    {
+        // Unprotected baseline, pointees are recycled and never freed.
+        {
+            static Obj pool[256];
+            cc::sync_ptr<Obj, mem::noop_deleter> ptr(&pool[0]);
+            std::atomic<bool> stop(false);
+            auto writer = start_writer(ptr, stop, [](size_t i) { return &pool[i % 256U]; });
+
+            auto ops = throughput(threads, [&ptr](size_t)
+            {
+                ptr->value_.load(std::memory_order_relaxed);
+            });
+            stop.store(true);
+            writer.join();
+            report("cc::sync_ptr get() unprotected", threads, ops);
+        }
+
+        // Hazard protected.
+        {
+            cc::hazard_sync_ptr<Obj> ptr(new Obj());
+            std::atomic<bool> stop(false);
+            auto writer = start_writer(ptr, stop, [](size_t i) { return new Obj(i); });
+
+            auto ops = throughput(threads, [&ptr](size_t)
+            {
+                static thread_local cc::hazard_guard guard;
+                ptr.get(guard)->value_.load(std::memory_order_relaxed);
+            });
+            stop.store(true);
+            writer.join();
+            report("cc::sync_ptr get(hazard_guard)", threads, ops);
+        }
+    }
+    cc::hazard_domain::instance().reclaim();
+}
@@ -0,0 +1,20 @@
+
+#ifndef __BENCH_CC_SYNC_PTR_HAZARD_H__
+#define __BENCH_CC_SYNC_PTR_HAZARD_H__
+
+#ifndef __CC_SYNC_PTR_HAZARD_H__
+#include "cc/sync_ptr_hazard.h"
+#endif
+
+
+namespace bench
+{
+    /**
+    * \brief Concurrent reads under a resetting writer.
+    * Compares unprotected get() against hazard protected get().
+    */
+    void cc_sync_ptr_hazard_reads(void);
+
+} // namespace bench
+
+#endif // __BENCH_CC_SYNC_PTR_HAZARD_H__
@@ -0,0 +1,34 @@
+
+#include "bench/bench.h"
+#include "bench/cc_sync_ptr_contention.h"
+#include "bench/cc_sync_ptr_hazard.h"
+#include "bench/mem_sync_ptr_intrusive.h"
+#include "bench/mem_sync_ptr_rcu.h"
+#include "bench/sync_ptr_churn.h"
+#include "bench/sync_ptr_counter.h"
+
+#include <cstdlib>
+
+
+int main(
+    int argc, char *argv[])
+    try
+{
+    if (argc > 1)
+    {
+        bench::duration() = std::chrono::milliseconds(std::atoi(argv[1]));
+    }
+
+    bench::cc_sync_ptr_contention_writes();
+    bench::cc_sync_ptr_hazard_reads();
+    bench::mem_sync_ptr_intrusive();
+    bench::mem_sync_ptr_rcu_reads();
+    bench::sync_ptr_counter_copy();
+    bench::sync_ptr_churn();
+
+    return 0;
+}
+catch (...)
+{
+    return 1;
+}
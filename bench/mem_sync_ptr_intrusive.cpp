@@ -0,0 +1,102 @@
+
+// Main header.
+#include "mem_sync_ptr_intrusive.h"
+
+#include "bench.h"
+
+#include "mem/sync_ptr.h"
+
+#include <cstdio>
+#include <vector>
+
+
+namespace
+{
+    static constexpr size_t batch_size = 16U;
+    static constexpr size_t chain_count = 1U << 16U;
+
+    struct Obj
+    {
+        size_t value_;
+        Obj(size_t p_value = 0) : value_(p_value) {}
+    };
+
+    struct IntrusiveObj
+        : public mem::intrusive_sync_base<IntrusiveObj>
+    {
+        size_t value_;
+        IntrusiveObj(size_t p_value = 0) : value_(p_value) {}
+    };
+
+    /**
+    * \brief Measure create, copy and dereference of one sync pointer type.
+    */
+    template<
+        class TSyncPtr,
+        class TObj>
+    void create_copy_deref(
+        char const * p_name)
+    {
+        char name[64];
+        std::atomic<size_t> sink(0);
+
+        std::snprintf(name, sizeof(name), "%s create", p_name);
+        for (auto threads : bench::thread_counts())
+        {
+            auto ops = bench::throughput(threads, [](size_t p_index)
+            {
+                std::vector<TSyncPtr> ptrs;
+                ptrs.reserve(batch_size);
+                for (size_t i = 0; i < batch_size; ++i)
+                {
+                    ptrs.emplace_back(new TObj(p_index));
+                }
+            });
+            bench::report(name, threads, ops * batch_size);
+        }
+
+        std::snprintf(name, sizeof(name), "%s copy", p_name);
+        TSyncPtr shared(new TObj());
+        for (auto threads : bench::thread_counts())
+        {
+            auto ops = bench::throughput(threads, [&shared, &sink](size_t)
+            {
+                TSyncPtr copy(shared);
+                sink.store(copy.count(), std::memory_order_relaxed);
+            });
+            bench::report(name, threads, ops);
+        }
+
+        // Chains allocated apart so dereferences miss the cache like graph edges would.
+        std::snprintf(name, sizeof(name), "%s dereference", p_name);
+        std::vector<TSyncPtr> chains;
+        chains.reserve(chain_count);
+        for (size_t i = 0; i < chain_count; ++i)
+        {
+            chains.emplace_back(new TObj(i));
+        }
+        for (auto threads : bench::thread_counts())
+        {
+            auto ops = bench::throughput(threads, [&chains, &sink](size_t p_index)
+            {
+                static thread_local size_t n = 0;
+                size_t sum = 0;
+                for (size_t i = 0; i < batch_size; ++i)
+                {
+                    n = (n + 4099U + p_index) & (chain_count - 1U);
+                    sum += chains[n]->value_;
+                }
+                sink.store(sum, std::memory_order_relaxed);
+            });
+            bench::report(name, threads, ops * batch_size);
+        }
+    }
+
+} // namespace
+
+
+void bench::mem_sync_ptr_intrusive(void)
+{
+    create_copy_deref<mem::sync_ptr<Obj>, Obj>("mem::sync_ptr");
+    create_copy_deref<mem::intrusive_sync_ptr<IntrusiveObj>, IntrusiveObj>("mem::intrusive_sync_ptr");
+}
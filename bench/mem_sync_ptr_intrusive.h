@@ -0,0 +1,20 @@
+
+#ifndef __BENCH_MEM_SYNC_PTR_INTRUSIVE_H__
+#define __BENCH_MEM_SYNC_PTR_INTRUSIVE_H__
+
+#ifndef __MEMORY_SYNC_PTR_INTRUSIVE_H__
+#include "mem/sync_ptr_intrusive.h"
+#endif
+
+
+namespace bench
+{
+    /**
+    * \brief Intrusive chains against mem::sync_ptr for small pointees:
+    * create/destroy, copy/destroy of a shared chain and dereference of many chains.
+    */
+    void mem_sync_ptr_intrusive(void);
+
+} // namespace bench
+
+#endif // __BENCH_MEM_SYNC_PTR_INTRUSIVE_H__
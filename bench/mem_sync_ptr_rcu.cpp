@@ -0,0 +1,50 @@
+
+// Main header.
+#include "mem_sync_ptr_rcu.h"
+
+#include "bench.h"
+#include "mem/sync_ptr.h"
+#include "mem/sync_ptr_cached.h"
+
+
+namespace
+{
+    struct Obj
+    {
+        size_t value_;
+        Obj(size_t p_value = 0) : value_(p_value) {}
+    };
+
+} // namespace
+
+
+void bench::mem_sync_ptr_rcu_reads(void)
+{
+    mem::sync_ptr<Obj, mem::default_deleter, mem::ptr_holder_ts> ptr_ts(new Obj());
+    mem::sync_ptr<Obj, mem::default_deleter, mem::ptr_holder_rcu> ptr_rcu(new Obj());
+
+    for (auto threads : thread_counts())
+    {
+        std::atomic<size_t> sink(0);
+
+        auto ops = throughput(threads, [&ptr_ts, &sink](size_t)
+        {
+            sink.store(ptr_ts->value_, std::memory_order_relaxed);
+        });
+        report("mem::sync_ptr get() ptr_holder_ts", threads, ops);
+
+        ops = throughput(threads, [&ptr_ts, &sink](size_t)
+        {
+            static thread_local mem::cached_reader<decltype(ptr_ts)> reader(ptr_ts);
+            sink.store(reader->value_, std::memory_order_relaxed);
+        });
+        report("mem::cached_reader get() ptr_holder_ts", threads, ops);
+
+        ops = throughput(threads, [&ptr_rcu, &sink](size_t)
+        {
+            mem::rcu_read_guard guard;
+            sink.store(ptr_rcu->value_, std::memory_order_relaxed);
+        });
+        report("mem::sync_ptr get() ptr_holder_rcu", threads, ops);
+    }
+}
@@ -0,0 +1,20 @@
+
+#ifndef __BENCH_MEM_SYNC_PTR_RCU_H__
+#define __BENCH_MEM_SYNC_PTR_RCU_H__
+
+#ifndef __MEMORY_SYNC_PTR_RCU_H__
+#include "mem/sync_ptr_rcu.h"
+#endif
+
+
+namespace bench
+{
+    /**
+    * \brief Read scaling of a shared chain.
+    * Compares ptr_holder_ts, read directly and through a cached_reader, against ptr_holder_rcu.
+    */
+    void mem_sync_ptr_rcu_reads(void);
+
+} // namespace bench
+
+#endif // __BENCH_MEM_SYNC_PTR_RCU_H__
@@ -0,0 +1,107 @@
+
+// Main header.
+#include "sync_ptr_churn.h"
+
+#include "bench.h"
+#include "cc/sync_ptr.h"
+#include "mem/sync_ptr.h"
+
+#include <new>
+#include <type_traits>
+
+
+namespace
+{
+    struct Obj
+    {
+        size_t value_;
+    };
+
+    struct Block
+    {
+        size_t values_[5];
+    };
+
+    const size_t batch_size = 16U;
+
+#if defined(SYNC_PTR_BODY_POOL)
+    char const * const bodies = "pooled";
+#else
+    char const * const bodies = "new/delete";
+#endif
+
+    /**
+    * \brief Each thread creates then destroys a batch of chains.
+    * Pointee is static, only bodies are allocated.
+    */
+    template<
+        class TSyncPtr>
+    void churn(
+        char const * p_name)
+    {
+        char name[64];
+        std::snprintf(name, sizeof(name), "%s churn (%s)", p_name, bodies);
+        for (auto threads : bench::thread_counts())
+        {
+            static Obj obj;
+            auto ops = bench::throughput(threads, [](size_t)
+            {
+                typename std::aligned_storage<sizeof(TSyncPtr), alignof(TSyncPtr)>::type ptrs[batch_size];
+                for (auto & p : ptrs)
+                {
+                    ::new (&p) TSyncPtr(&obj);
+                }
+                for (auto & p : ptrs)
+                {
+                    reinterpret_cast<TSyncPtr &>(p).~TSyncPtr();
+                }
+            });
+            bench::report(name, threads, ops * batch_size);
+        }
+
+#if defined(SYNC_PTR_BODY_POOL)
+        auto stats = TSyncPtr::body_pool_stats();
+        std::printf("%-48s hit rate %.4f, %zu slabs\n", name, stats.hit_rate(), stats.slabs_);
+#endif
+    }
+
+} // namespace
+
+
+void bench::sync_ptr_churn(void)
+{
+    for (auto threads : thread_counts())
+    {
+        auto ops = throughput(threads, [](size_t)
+        {
+            void * blocks[batch_size];
+            for (auto & b : blocks)
+            {
+                b = ::operator new(sizeof(Block));
+            }
+            for (auto * b : blocks)
+            {
+                ::operator delete(b);
+            }
+        });
+        report("operator new/delete block churn", threads, ops * batch_size);
+
+        auto & pool = mem::body_pool<Block>::instance();
+        ops = throughput(threads, [&pool](size_t)
+        {
+            void * blocks[batch_size];
+            for (auto & b : blocks)
+            {
+                b = pool.allocate();
+            }
+            for (auto * b : blocks)
+            {
+                pool.deallocate(b);
+            }
+        });
+        report("body_pool block churn", threads, ops * batch_size);
+    }
+
+    churn<mem::sync_ptr<Obj, mem::noop_deleter>>("mem::sync_ptr");
+    churn<cc::sync_ptr<Obj, mem::noop_deleter>>("cc::sync_ptr");
+}
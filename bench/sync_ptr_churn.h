@@ -0,0 +1,21 @@
+
+#ifndef __BENCH_SYNC_PTR_CHURN_H__
+#define __BENCH_SYNC_PTR_CHURN_H__
+
+#ifndef __MEMORY_SYNC_PTR_POOL_H__
+#include "mem/sync_ptr_pool.h"
+#endif
+
+
+namespace bench
+{
+    /**
+    * \brief Chain create/destroy churn, bodies come from new/delete 
+    * or from the body pool when built with SYNC_PTR_BODY_POOL (sync_ptr_bench_pool).
+    * Also compares raw body_pool against new/delete for a body sized block.
+    */
+    void sync_ptr_churn(void);
+
+} // namespace bench
+
+#endif // __BENCH_SYNC_PTR_CHURN_H__
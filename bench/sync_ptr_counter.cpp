@@ -0,0 +1,84 @@
+
+// Main header.
+#include "sync_ptr_counter.h"
+
+#include "bench.h"
+
+
+namespace
+{
+    struct Obj
+    {
+        size_t value_;
+        Obj(size_t p_value = 0) : value_(p_value) {}
+    };
+
+    /**
+    * \brief Sequentially consistent reference counter, baseline.
+    */
+    class seq_cst_ref_counter
+    {
+
+    private:
+        std::atomic<size_t>	        ref_count_;
+        std::atomic<size_t>	        ref_count_ptr_;
+
+    public:
+        seq_cst_ref_counter(void) noexcept : ref_count_(1U), ref_count_ptr_(0) {}
+        void increment(void) noexcept { ref_count_.fetch_add(1U); }
+        size_t decrement(void) noexcept { return ref_count_.fetch_sub(1U); }
+        void increment_ptr(void) noexcept { ref_count_ptr_.fetch_add(1U); }
+        size_t decrement_ptr(void) noexcept { return ref_count_ptr_.fetch_sub(1U); }
+        size_t count(void) const noexcept { return ref_count_.load(); }
+        size_t count_ptr(void) const noexcept { return ref_count_ptr_.load(); }
+    };
+
+    /**
+    * \brief Even threads copy and destroy the chain, odd threads read it.
+    */
+    template<
+        class TSyncPtr>
+    void copy_and_read(
+        char const * p_name)
+    {
+        TSyncPtr ptr(new Obj());
+        std::atomic<size_t> sink(0);
+        for (auto threads : bench::thread_counts())
+        {
+            auto ops = bench::throughput(threads, [&ptr, &sink](size_t p_index)
+            {
+                if (p_index % 2U == 0)
+                {
+                    TSyncPtr copy(ptr);
+                    sink.store(copy.count(), std::memory_order_relaxed);
+                }
+                else
+                {
+                    sink.store(ptr.get()->value_, std::memory_order_relaxed);
+                }
+            });
+            bench::report(p_name, threads, ops);
+        }
+    }
+
+} // namespace
+
+
+void bench::sync_ptr_counter_copy(void)
+{
+    copy_and_read<mem::sync_ptr<Obj, mem::default_deleter, mem::ptr_holder, seq_cst_ref_counter>>(
+        "mem::sync_ptr copy seq_cst_ref_counter");
+    copy_and_read<mem::sync_ptr<Obj, mem::default_deleter, mem::ptr_holder, mem::atomic_ref_counter>>(
+        "mem::sync_ptr copy atomic_ref_counter");
+    copy_and_read<mem::sync_ptr<Obj, mem::default_deleter, mem::ptr_holder, mem::padded_atomic_ref_counter>>(
+        "mem::sync_ptr copy padded_atomic_ref_counter");
+    copy_and_read<mem::sync_ptr<Obj, mem::default_deleter, mem::ptr_holder, mem::packed_ref_counter>>(
+        "mem::sync_ptr copy packed_ref_counter");
+    copy_and_read<mem::sync_ptr<Obj, mem::default_deleter, mem::ptr_holder, mem::sharded_ref_counter>>(
+        "mem::sync_ptr copy sharded_ref_counter");
+
+    copy_and_read<cc::sync_ptr<Obj, cc::sync_ptr_deleter, cc::body_layout>>(
+        "cc::sync_ptr copy body_layout");
+    copy_and_read<cc::sync_ptr<Obj, cc::sync_ptr_deleter, cc::padded_body_layout>>(
+        "cc::sync_ptr copy padded_body_layout");
+}
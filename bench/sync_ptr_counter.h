@@ -0,0 +1,28 @@
+
+#ifndef __BENCH_SYNC_PTR_COUNTER_H__
+#define __BENCH_SYNC_PTR_COUNTER_H__
+
+#ifndef __CC_SYNC_PTR_H__
+#include "cc/sync_ptr.h"
+#endif
+
+#ifndef __MEMORY_SYNC_PTR_H__
+#include "mem/sync_ptr.h"
+#endif
+
+#ifndef __MEMORY_SYNC_PTR_SHARDED_H__
+#include "mem/sync_ptr_sharded.h"
+#endif
+
+
+namespace bench
+{
+    /**
+    * \brief Copy/destroy throughput of a shared chain, half the threads copy, half read.
+    * Compares sequentially consistent, tuned, padded and sharded counters and layouts.
+    */
+    void sync_ptr_counter_copy(void);
+
+} // namespace bench
+
+#endif // __BENCH_SYNC_PTR_COUNTER_H__
@@ -4,13 +4,24 @@
 
 #include <cassert>
 #include <atomic>
+#include <cstddef>
 #include <functional>
 #include <memory>
+#include <new>
+#include <stdexcept>
 
 #ifndef __MEMORY_SYNC_PTR_POLICY_H__
 #include "mem/sync_ptr_policy.h"
 #endif
 
+#ifndef __MEMORY_SYNC_PTR_POOL_H__
+#include "mem/sync_ptr_pool.h"
+#endif
+
+#ifndef __MEMORY_SYNC_PTR_VERSION_H__
+#include "mem/sync_ptr_version.h"
+#endif
+
 
 namespace cc
 {
@@ -20,6 +31,90 @@ namespace cc
     template<class TPtr>
     using sync_ptr_deleter      = mem::default_deleter<TPtr>;
 
+
+    /**
+    * \brief Compact body layout.
+    * Reference counts and pointer share a cache line.
+    */
+    template<
+        class TPtr>
+    struct body_layout
+    {
+        std::atomic<size_t>	        ref_count_;
+        std::atomic<size_t>	        ref_count_ptr_;
+        std::atomic<TPtr *>		    ptr_;
+
+        body_layout(
+            size_t p_ref_count,
+            size_t p_ref_count_ptr,
+            TPtr * p_ptr)
+            noexcept
+            : ref_count_(p_ref_count)
+            , ref_count_ptr_(p_ref_count_ptr)
+            , ptr_(p_ptr)
+        {}
+
+    }; // struct body_layout
+
+    /**
+    * \brief Padded body layout.
+    * Reference counts and pointer each sit on their own cache line, 
+    * copies and destructions don't false-share with pointer loads.
+    */
+    template<
+        class TPtr>
+    struct padded_body_layout
+    {
+        std::atomic<size_t>	        ref_count_;
+        char                        pad0_[mem::cache_line_size];
+        std::atomic<size_t>	        ref_count_ptr_;
+        char                        pad1_[mem::cache_line_size];
+        std::atomic<TPtr *>		    ptr_;
+        char                        pad2_[mem::cache_line_size];
+
+        padded_body_layout(
+            size_t p_ref_count,
+            size_t p_ref_count_ptr,
+            TPtr * p_ptr)
+            noexcept
+            : ref_count_(p_ref_count)
+            , ref_count_ptr_(p_ref_count_ptr)
+            , ptr_(p_ptr)
+        {}
+
+    }; // struct padded_body_layout
+
+    template<class TPtr>
+    using sync_ptr_layout       = body_layout<TPtr>;
+
+
+    /**
+    * \brief Tag selecting the unconditional reset(), release() and exchange() overloads.
+    */
+    struct wait_free_t
+    {
+        explicit wait_free_t(
+            void) = default;
+    };
+
+    static constexpr wait_free_t wait_free{};
+
+
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class TLayout = sync_ptr_layout>
+    class sync_ref;
+
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class TLayout = sync_ptr_layout>
+    class sync_weak_ptr;
+
+    class sync_group;
+
+
     /**
     * \class cc::sync_ptr
     *
@@ -27,16 +122,23 @@ namespace cc
     * Used to avoid cross module cycle.
     * When the original sync_ptr or one of its copy underlying raw pointer changes,
     * all sync_ptr and copies point to the updated raw pointer.
+    *
+    * Default constructed and moved-from sync_ptr hold no body and allocate nothing.
+    * They are not part of any chain, copies of them are independent empty sync_ptr,
+    * and the first reset() or exchange() gives them a chain of their own.
     */
     template <
         class TPtr,
-        template <class T> class TDeleter = sync_ptr_deleter >
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class TLayout = sync_ptr_layout >
     class sync_ptr final
     {
 
     public:
         typedef typename TPtr		    pointer_type;
+        typedef typename std::remove_extent<TPtr>::type element_type;
         typedef typename TDeleter<TPtr>	deleter_type;
+        typedef typename TLayout<TPtr>	layout_type;
 
 
     private:
@@ -46,10 +148,12 @@ namespace cc
         * \brief Reference counted template type pointer.
         * Deletes pointer when reference count drops to zero.
         * Reference count and pointer are atomic.
+        * Increments are relaxed, decrements acq_rel and loads acquire.
         */
         template<
             class TPtr,
-            template <class T> class TDeleter>
+            template <class T> class TDeleter,
+            template <class T> class TLayout>
         class body final
             : private TDeleter<TPtr>
         {
@@ -59,9 +163,25 @@ namespace cc
             //////////////////////////////////////
 
         private:
-            std::atomic<size_t>	        ref_count_;
-            std::atomic<size_t>	        ref_count_ptr_;
-            std::atomic<TPtr *>		    ptr_;
+            typedef void (*dispose_t)(body *);
+            typedef void (*destroy_t)(body *, TPtr *);
+
+            /**
+            * \brief Storage of the chain: how the body is freed and a pointee living in its block destroyed.
+            */
+            struct storage
+            {
+                dispose_t       dispose_;
+                destroy_t       destroy_;
+                bool            detachable_;
+            };
+
+        private:
+            TLayout<TPtr>               layout_;
+            storage const *             storage_;
+            TPtr *                      inplace_;
+            mem::version_word           version_;
+            std::atomic<size_t>         cas_failures_;
 
 
             //////////////////////////////////////
@@ -75,24 +195,17 @@ namespace cc
             void operator=(body && p_arg) = delete;
 
         public:
-            body(
-                void)
-                noexcept
-                // Members.
-                : ref_count_(0)
-                , ref_count_ptr_(0)
-                , ptr_(nullptr)
-            {}
-
             template<
                 class TPtrCompatible>
             body(
                 TPtrCompatible * p_ptr)
                 noexcept
                 // Members.
-                : ref_count_(1U)
-                , ref_count_ptr_(1U)
-                , ptr_(p_ptr)
+                : layout_(1U, 1U, p_ptr)
+                , storage_(&storage_of<&dispose_delete, nullptr, true>::value)
+                , inplace_(nullptr)
+                , version_()
+                , cas_failures_(0)
             {
                 assert(p_ptr);
             }
@@ -104,6 +217,229 @@ namespace cc
             {}
 
 
+        public:
+            /**
+            * \brief Create body and pointee in a single allocation.
+            * The pointee is constructed in a slot trailing the body.
+            */
+            template<
+                class... TArgs>
+            static body * create_inplace(
+                TArgs&&... p_args)
+            {
+                static_assert(
+                    alignof(TPtr) <= alignof(std::max_align_t),
+                    "Over-aligned types can't be constructed in place.");
+                static_assert(
+                    mem::is_immediate_deleter<TDeleter<TPtr>>::value,
+                    "In place pointees need a deleter freeing synchronously, the slot can't be retired.");
+                static_assert(
+                    std::is_move_constructible<TPtr>::value,
+                    "In place pointees must be movable to leave the chain through release() or exchange().");
+
+                void * mem = ::operator new(inplace_offset() + sizeof(TPtr));
+                TPtr * ptr = nullptr;
+                try
+                {
+                    ptr = ::new (static_cast<char *>(mem) + inplace_offset()) TPtr(
+                        std::forward<TArgs>(p_args)...);
+                }
+                catch (...)
+                {
+                    ::operator delete(mem);
+                    throw;
+                }
+
+                body * b = ::new (mem) body(ptr);
+                b->storage_ = &storage_of<&dispose_inplace, &destroy_inplace_slot, true>::value;
+                b->inplace_ = ptr;
+                return b;
+            }
+
+
+            /**
+            * \brief Create body and pointee in a single block obtained from target allocator.
+            * The pointee is constructed through the allocator, so uses-allocator types
+            * (std::pmr containers) get the same memory resource.
+            * A copy of the allocator, rebound to max_align_t, is kept in the block to free it.
+            */
+            template<
+                class TAlloc,
+                class... TArgs>
+            static body * create_allocated(
+                TAlloc const & p_alloc,
+                TArgs&&... p_args)
+            {
+                typedef typename std::allocator_traits<TAlloc>::template rebind_alloc<std::max_align_t> unit_alloc_t;
+                typedef typename std::allocator_traits<TAlloc>::template rebind_alloc<TPtr> ptr_alloc_t;
+                typedef std::allocator_traits<unit_alloc_t> unit_traits_t;
+
+                static_assert(
+                    alignof(TPtr) <= alignof(std::max_align_t) && alignof(unit_alloc_t) <= alignof(std::max_align_t),
+                    "Over-aligned types can't be constructed in place.");
+                static_assert(
+                    std::is_pointer<typename unit_traits_t::pointer>::value,
+                    "Allocators with fancy pointers aren't supported.");
+                static_assert(
+                    mem::is_immediate_deleter<TDeleter<TPtr>>::value,
+                    "In place pointees need a deleter freeing synchronously, the slot can't be retired.");
+                static_assert(
+                    std::is_move_constructible<TPtr>::value,
+                    "In place pointees must be movable to leave the chain through release() or exchange().");
+
+                unit_alloc_t alloc(p_alloc);
+                auto * mem = reinterpret_cast<char *>(
+                    unit_traits_t::allocate(alloc, allocated_units<unit_alloc_t>()));
+                auto * ptr = reinterpret_cast<TPtr *>(mem + allocated_ptr_offset<unit_alloc_t>());
+                try
+                {
+                    ptr_alloc_t ptr_alloc(alloc);
+                    std::allocator_traits<ptr_alloc_t>::construct(
+                        ptr_alloc,
+                        ptr,
+                        std::forward<TArgs>(p_args)...);
+                }
+                catch (...)
+                {
+                    unit_traits_t::deallocate(
+                        alloc,
+                        reinterpret_cast<std::max_align_t *>(mem),
+                        allocated_units<unit_alloc_t>());
+                    throw;
+                }
+
+                ::new (mem + allocated_alloc_offset<unit_alloc_t>()) unit_alloc_t(std::move(alloc));
+                body * b = ::new (mem) body(ptr);
+                b->storage_ = &storage_of<&dispose_allocated<unit_alloc_t>, &destroy_allocated<unit_alloc_t>, false>::value;
+                b->inplace_ = ptr;
+                return b;
+            }
+
+
+#if defined(SYNC_PTR_BODY_POOL)
+            /**
+            * \brief Allocate bodies from the slab pool of their type.
+            */
+            static void * operator new(
+                size_t p_size)
+            {
+                assert(p_size == sizeof(body));
+                return mem::body_pool<body>::instance().allocate();
+            }
+
+            static void operator delete(
+                void * p_ptr)
+                noexcept
+            {
+                mem::body_pool<body>::instance().deallocate(p_ptr);
+            }
+#endif // SYNC_PTR_BODY_POOL
+
+
+        private:
+            static constexpr size_t inplace_offset(
+                void)
+                noexcept
+            {
+                return (sizeof(body) + alignof(TPtr) - 1U) & ~(alignof(TPtr) - 1U);
+            }
+
+            static void dispose_delete(
+                body * p_body)
+            {
+                delete p_body;
+            }
+
+            static void dispose_inplace(
+                body * p_body)
+            {
+                p_body->~body();
+                ::operator delete(p_body);
+            }
+
+            static constexpr size_t align_up(
+                size_t p_size,
+                size_t p_align)
+                noexcept
+            {
+                return (p_size + p_align - 1U) & ~(p_align - 1U);
+            }
+
+            template<
+                class TUnitAlloc>
+            static constexpr size_t allocated_alloc_offset(
+                void)
+                noexcept
+            {
+                return align_up(sizeof(body), alignof(TUnitAlloc));
+            }
+
+            template<
+                class TUnitAlloc>
+            static constexpr size_t allocated_ptr_offset(
+                void)
+                noexcept
+            {
+                return align_up(allocated_alloc_offset<TUnitAlloc>() + sizeof(TUnitAlloc), alignof(TPtr));
+            }
+
+            template<
+                class TUnitAlloc>
+            static constexpr size_t allocated_units(
+                void)
+                noexcept
+            {
+                return align_up(allocated_ptr_offset<TUnitAlloc>() + sizeof(TPtr), sizeof(std::max_align_t)) /
+                    sizeof(std::max_align_t);
+            }
+
+            template<
+                class TUnitAlloc>
+            static void dispose_allocated(
+                body * p_body)
+            {
+                auto * mem = reinterpret_cast<char *>(p_body);
+                auto * slot = reinterpret_cast<TUnitAlloc *>(mem + allocated_alloc_offset<TUnitAlloc>());
+                TUnitAlloc alloc(std::move(*slot));
+                slot->~TUnitAlloc();
+                p_body->~body();
+                std::allocator_traits<TUnitAlloc>::deallocate(
+                    alloc,
+                    reinterpret_cast<std::max_align_t *>(mem),
+                    allocated_units<TUnitAlloc>());
+            }
+
+            template<
+                class TUnitAlloc>
+            static void destroy_allocated(
+                body * p_body,
+                TPtr * p_ptr)
+            {
+                typedef typename std::allocator_traits<TUnitAlloc>::template rebind_alloc<TPtr> ptr_alloc_t;
+
+                auto * slot = reinterpret_cast<TUnitAlloc *>(
+                    reinterpret_cast<char *>(p_body) + allocated_alloc_offset<TUnitAlloc>());
+                ptr_alloc_t alloc(*slot);
+                std::allocator_traits<ptr_alloc_t>::destroy(alloc, p_ptr);
+            }
+
+            static void destroy_inplace_slot(
+                body *,
+                TPtr * p_ptr)
+            {
+                destroy_inplace(p_ptr);
+            }
+
+            template<
+                dispose_t TDispose,
+                destroy_t TDestroy,
+                bool TDetachable>
+            struct storage_of
+            {
+                static constexpr storage value = { TDispose, TDestroy, TDetachable };
+            };
+
+
         private:
             /**
             * \brief Delete this.
@@ -113,8 +449,119 @@ namespace cc
                 void)
                 noexcept
             {
-                delete this;
+                storage_->dispose_(this);
+            }
+            /**
+            * \brief Free pointer previously held by this.
+            * The in-place slot is destroyed, separately allocated pointers go to the deleter.
+            */
+            inline void dispose_ptr(
+                TPtr * p_ptr)
+                noexcept
+            {
+                if (p_ptr == inplace_)
+                {
+                    storage_->destroy_(this, p_ptr);
+                }
+                else
+                {
+                    free(p_ptr);
+                }
+            }
+            /**
+            * \brief Throw std::logic_error while the pointee built with an allocator is current,
+            * it lives in the allocator block and can't leave the chain.
+            * Once replaced the slot never comes back, so the check can't race with reset().
+            */
+            inline void check_detachable(
+                void)
+                const
+            {
+                if (!storage_->detachable_ && get_ptr() == inplace_)
+                {
+                    throw std::logic_error("Pointees built with an allocator can't leave their chain.");
+                }
+            }
+
+            /**
+            * \brief Hand out pointer previously held by this.
+            * The in-place slot is moved to its own allocation so ownership can leave the chain,
+            * if that throws the in-place pointee is destroyed and the exception propagates.
+            */
+            inline TPtr * detach_ptr(
+                TPtr * p_ptr)
+            {
+                if (p_ptr && p_ptr == inplace_)
+                {
+                    return relocate(
+                        p_ptr,
+                        std::is_move_constructible<TPtr>());
+                }
+                return p_ptr;
+            }
+
+            static TPtr * relocate(
+                TPtr * p_ptr,
+                std::true_type)
+            {
+                TPtr * ptr = nullptr;
+                try
+                {
+                    ptr = new TPtr(std::move(*p_ptr));
+                }
+                catch (...)
+                {
+                    destroy_inplace(p_ptr);
+                    throw;
+                }
+                destroy_inplace(p_ptr);
+                return ptr;
+            }
+
+            /**
+            * \brief Never reached, in place construction requires movable pointees.
+            */
+            static TPtr * relocate(
+                TPtr * p_ptr,
+                std::false_type)
+                noexcept
+            {
+                assert(!"In-place pointee isn't movable and can't leave the chain.");
+                return p_ptr;
+            }
+            /**
+            * \brief Destroy the in-place slot, arrays never live in it.
+            */
+            static inline void destroy_inplace(
+                TPtr * p_ptr)
+                noexcept
+            {
+                destroy_inplace(p_ptr, std::is_array<TPtr>());
+            }
+
+            static inline void destroy_inplace(
+                TPtr * p_ptr,
+                std::false_type)
+                noexcept
+            {
+                p_ptr->~TPtr();
+            }
+
+            static inline void destroy_inplace(
+                TPtr *,
+                std::true_type)
+                noexcept
+            {}
+            /**
+            * \brief Bump version after a pointer change.
+            */
+            inline void bump_version(
+                void)
+                noexcept
+            {
+                version_.bump();
             }
+
             /**
             * \brief Delete contained pointer and store target one using CAS.
             */
@@ -122,20 +569,90 @@ namespace cc
                 TPtr * p_ptr)
                 noexcept
             {
-                auto ptr = ptr_.load();
-                if (ptr_.compare_exchange_strong(
-                    ptr,
-                    p_ptr))
+                auto expected = load_expected(layout_.ptr_);
+                if (layout_.ptr_.compare_exchange_strong(
+                    expected,
+                    p_ptr,
+                    std::memory_order_acq_rel))
                 {
-                    if (ptr)
+                    bump_version();
+                    if (auto * ptr = expected_ptr(expected))
                     {
-                        free(ptr);
+                        dispose_ptr(ptr);
                     }
                     return true;
                 }
+                count_cas_failure();
                 return false;
             }
 
+            /**
+            * \brief Count a failed pointer CAS, see sync_ptr::cas_failures().
+            */
+            inline void count_cas_failure(
+                void)
+                noexcept
+            {
+                cas_failures_.fetch_add(1U, std::memory_order_relaxed);
+            }
+
+            /**
+            * \brief Load pointer as a CAS expectation.
+            * Tagged layouts (see tagged_body_layout) load pointer and generation together.
+            */
+            static inline TPtr * load_expected(
+                std::atomic<TPtr *> const & p_src)
+                noexcept
+            {
+                return p_src.load(std::memory_order_acquire);
+            }
+
+            template<
+                class TSrc>
+            static inline auto load_expected(
+                TSrc const & p_src)
+                noexcept -> decltype(p_src.load_tagged())
+            {
+                return p_src.load_tagged(std::memory_order_acquire);
+            }
+
+            static inline TPtr * expected_ptr(
+                TPtr * p_expected)
+                noexcept
+            {
+                return p_expected;
+            }
+
+            template<
+                class TExpected>
+            static inline TPtr * expected_ptr(
+                TExpected const & p_expected)
+                noexcept
+            {
+                return p_expected.ptr_;
+            }
+
+            /**
+            * \brief Pointer changes count, from the pointer word with tagged layouts.
+            */
+            inline size_t generation_of(
+                std::atomic<TPtr *> const &,
+                std::memory_order p_order)
+                const noexcept
+            {
+                return version_.load(p_order);
+            }
+
+            template<
+                class TSrc>
+            inline size_t generation_of(
+                TSrc const & p_src,
+                std::memory_order p_order)
+                const noexcept
+            {
+                return p_src.generation(p_order);
+            }
+
 
         public:
             /**
@@ -145,7 +662,7 @@ namespace cc
                 void)
                 noexcept
             {
-                ref_count_.fetch_add(1U);
+                layout_.ref_count_.fetch_add(1U, std::memory_order_relaxed);
             }
             /**
             * \brief Decrements this reference count,
@@ -155,7 +672,7 @@ namespace cc
                 void)
                 noexcept
             {
-                if (ref_count_.fetch_sub(1U) == 1U)
+                if (layout_.ref_count_.fetch_sub(1U, std::memory_order_acq_rel) == 1U)
                 {
                     release_this();
                 }
@@ -168,9 +685,9 @@ namespace cc
                 void)
                 noexcept
             {
-                if (ptr_.load())
+                if (layout_.ptr_.load(std::memory_order_acquire))
                 {
-                    ref_count_ptr_.fetch_add(1U);
+                    layout_.ref_count_ptr_.fetch_add(1U, std::memory_order_relaxed);
                 }
             }
             /**
@@ -181,14 +698,40 @@ namespace cc
                 void)
                 noexcept
             {
-                if (ptr_.load())
+                if (layout_.ptr_.load(std::memory_order_acquire))
                 {
-                    if (ref_count_ptr_.fetch_sub(1U) == 1U)
+                    if (layout_.ref_count_ptr_.fetch_sub(1U, std::memory_order_acq_rel) == 1U)
                     {
                         release_ptr_cas(nullptr);
                     }
                 }
             }
+            /**
+            * \brief Increments pointer reference count unless the pointer was already released.
+            * Return true on success, see sync_weak_ptr::lock().
+            * Like ref_ptr(), an empty chain isn't counted, unref_ptr() won't count it down.
+            */
+            inline bool try_ref_ptr(
+                void)
+                noexcept
+            {
+                auto n = layout_.ref_count_ptr_.load(std::memory_order_relaxed);
+                if (!layout_.ptr_.load(std::memory_order_acquire))
+                {
+                    return n > 0;
+                }
+                while (n > 0)
+                {
+                    if (layout_.ref_count_ptr_.compare_exchange_weak(
+                        n,
+                        n + 1U,
+                        std::memory_order_relaxed))
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
 
 
             ///////////////////////////////////////////////////////////////////////////////////////
@@ -200,13 +743,13 @@ namespace cc
                 void)
                 const noexcept
             {
-                return ref_count_.load();
+                return layout_.ref_count_.load(std::memory_order_acquire);
             }
             inline size_t get_ref_count_ptr(
                 void)
                 const noexcept
             {
-                return ref_count_ptr_.load();
+                return layout_.ref_count_ptr_.load(std::memory_order_acquire);
             }
 
 
@@ -215,17 +758,67 @@ namespace cc
                 void)
                 const noexcept
             {
-                return ptr_.load();
+                return layout_.ptr_.load(std::memory_order_acquire);
             }
 
             template<
-                class TPtrCompatible>
-            inline bool set_ptr(
-                TPtrCompatible * p_ptr)
-                noexcept
+                class TGuard>
+            inline TPtr * get_ptr(
+                TGuard & p_guard)
+                const noexcept
             {
-                assert(p_ptr);
-                assert(p_ptr != ptr_.load());
+                return p_guard.protect(layout_.ptr_);
+            }
+
+            /**
+            * \brief Number of pointer changes, bumped after each one.
+            */
+            inline size_t get_version(
+                std::memory_order p_order)
+                const noexcept
+            {
+                return version_.load(p_order);
+            }
+
+            inline size_t get_generation(
+                std::memory_order p_order)
+                const noexcept
+            {
+                return generation_of(layout_.ptr_, p_order);
+            }
+
+            inline size_t get_cas_failures(
+                void)
+                const noexcept
+            {
+                return cas_failures_.load(std::memory_order_relaxed);
+            }
+
+            inline mem::version_word const & get_version_word(
+                void)
+                const noexcept
+            {
+                return version_;
+            }
+
+            /**
+            * \brief Bump version without pointer change, see sync_ptr::notify().
+            */
+            inline void notify_version(
+                void)
+                noexcept
+            {
+                version_.bump();
+            }
+
+            template<
+                class TPtrCompatible>
+            inline bool set_ptr(
+                TPtrCompatible * p_ptr)
+                noexcept
+            {
+                assert(p_ptr);
+                assert(p_ptr != get_ptr());
                 return release_ptr_cas(p_ptr);
             }
 
@@ -240,13 +833,22 @@ namespace cc
                 class TPtrCompatible>
             inline bool release(
                 TPtrCompatible ** p_out)
-                noexcept
             {
                 assert(*p_out != get_ptr());
-                *p_out = ptr_.load();
-                return ptr_.compare_exchange_strong(
-                    *p_out,
-                    nullptr);
+                check_detachable();
+                auto expected = load_expected(layout_.ptr_);
+                if (layout_.ptr_.compare_exchange_strong(
+                    expected,
+                    nullptr,
+                    std::memory_order_acq_rel))
+                {
+                    bump_version();
+                    *p_out = detach_ptr(expected_ptr(expected));
+                    return true;
+                }
+                *p_out = expected_ptr(expected);
+                count_cas_failure();
+                return false;
             }
 
             template<
@@ -254,15 +856,81 @@ namespace cc
             inline bool exchange(
                 TPtr ** p_out,
                 TPtrCompatible * p_ptr)
-                noexcept
             {
                 assert(*p_out != get_ptr());
                 assert(p_ptr);
                 assert(p_ptr != get_ptr());
-                *p_out = ptr_.load();
-                return ptr_.compare_exchange_strong(
-                    *p_out,
-                    p_ptr);
+                check_detachable();
+                auto expected = load_expected(layout_.ptr_);
+                if (layout_.ptr_.compare_exchange_strong(
+                    expected,
+                    p_ptr,
+                    std::memory_order_acq_rel))
+                {
+                    bump_version();
+                    *p_out = detach_ptr(expected_ptr(expected));
+                    return true;
+                }
+                *p_out = expected_ptr(expected);
+                count_cas_failure();
+                return false;
+            }
+
+
+            ///////////////////////////////////////////////////////////////////////////////////////
+            //		GROUP (see sync_group)
+            ///////////////////////////////////////////////////////////////////////////////////////
+
+        public:
+            /**
+            * \brief Set pointer and return previous one, which is left to retire_ptr().
+            */
+            inline TPtr * swap_ptr(
+                TPtr * p_ptr)
+                noexcept
+            {
+                auto p = layout_.ptr_.exchange(p_ptr, std::memory_order_acq_rel);
+                bump_version();
+                return p;
+            }
+
+            /**
+            * \brief Free pointer swapped out of, or never published to, this.
+            */
+            inline void retire_ptr(
+                TPtr * p_ptr)
+                noexcept
+            {
+                if (p_ptr)
+                {
+                    dispose_ptr(p_ptr);
+                }
+            }
+
+
+            ///////////////////////////////////////////////////////////////////////////////////////
+            //		WAIT-FREE (see wait_free_t)
+            ///////////////////////////////////////////////////////////////////////////////////////
+
+        public:
+            /**
+            * \brief Set pointer and free previous one, no CAS.
+            */
+            inline void store_ptr(
+                TPtr * p_ptr)
+                noexcept
+            {
+                retire_ptr(swap_ptr(p_ptr));
+            }
+
+            /**
+            * \brief Set pointer and hand out previous one, no CAS.
+            */
+            inline TPtr * exchange_ptr(
+                TPtr * p_ptr)
+            {
+                check_detachable();
+                return detach_ptr(swap_ptr(p_ptr));
             }
 
         }; // class body
@@ -275,36 +943,97 @@ namespace cc
     private:
         typedef typename sync_ptr<
             TPtr,
-            TDeleter> sync_ptr_t;
+            TDeleter,
+            TLayout> sync_ptr_t;
 
         typedef typename body<
             TPtr,
-            TDeleter> body_t;
+            TDeleter,
+            TLayout> body_t;
 
 
     private:
         body_t *		body_;
 
+        friend class sync_ref<
+            TPtr,
+            TDeleter,
+            TLayout>;
+
+        friend class sync_weak_ptr<
+            TPtr,
+            TDeleter,
+            TLayout>;
+
+        friend class sync_group;
+
+        friend struct mem::version_access;
+
 
         //////////////////////////////////////
         //              METHODS             //
         //////////////////////////////////////
 
+    private:
+        /**
+        * \brief Construct sharing target body, see sync_ref::sync().
+        */
+        explicit sync_ptr(
+            body_t * p_body)
+            noexcept
+            // Members.
+            : body_(p_body)
+        {
+            link(body_);
+        }
+
     public:
-        sync_ptr(
+        /**
+        * \brief Construct default empty object.
+        * No body is allocated until a pointer is set.
+        */
+        constexpr sync_ptr(
             void)
             noexcept
             // Members.
-            : body_(new body_t())
+            : body_(nullptr)
         {}
 
         template<
             class TPtrCompatible>
         sync_ptr(
             TPtrCompatible * p_ptr)
-            noexcept
             // Members.
-            : body_(new body_t(p_ptr))
+            : body_(create_body(p_ptr))
+        {}
+
+        /**
+        * \brief Construct pointee in place.
+        * Body and pointee share a single allocation.
+        */
+        template<
+            class... TArgs>
+        explicit sync_ptr(
+            mem::inplace_t,
+            TArgs&&... p_args)
+            // Members.
+            : body_(body_t::create_inplace(std::forward<TArgs>(p_args)...))
+        {}
+
+        /**
+        * \brief Construct pointee with target allocator.
+        * Body and pointee share a single block obtained from the allocator, which also destroys the pointee.
+        * The pointee can't leave the chain, release() and exchange() throw std::logic_error while it is current.
+        */
+        template<
+            class TAlloc,
+            class... TArgs>
+        explicit sync_ptr(
+            std::allocator_arg_t,
+            TAlloc const & p_alloc,
+            TArgs&&... p_args)
+            // Members.
+            : body_(body_t::create_allocated(p_alloc, std::forward<TArgs>(p_args)...))
         {}
 
         sync_ptr(
@@ -322,30 +1051,26 @@ namespace cc
             // Members.
             : body_(p_other.body_)
         {
-            body_->ref();
-            body_->ref_ptr();
+            link(body_);
         }
 
         ~sync_ptr(
             void)
             noexcept
         {
-            if (body_)
-            {
-                body_->unref_ptr();
-                body_->unref();
-            }
+            unlink(body_);
         }
 
         inline sync_ptr_t & operator=(
             sync_ptr_t && p_other)
             noexcept
         {
-            auto * tmp = p_other.body_;
-            if (tmp != body_)
+            if (&p_other != this)
             {
-                body_ = tmp;
+                auto * tmp = body_;
+                body_ = p_other.body_;
                 p_other.body_ = nullptr;
+                unlink(tmp);
             }
             return *this;
         }
@@ -357,12 +1082,10 @@ namespace cc
             auto * tmp = p_other.body_;
             if (tmp != body_)
             {
-                body_->unref_ptr();
-                body_->unref();
+                unlink(body_);
 
                 body_ = tmp;
-                body_->ref();
-                body_->ref_ptr();
+                link(body_);
             }
             return *this;
         }
@@ -377,13 +1100,117 @@ namespace cc
         }
 
 
+    private:
+        /**
+        * \brief Create a body owning target pointer, free the pointer if the body can't be allocated.
+        */
+        template<
+            class TPtrCompatible>
+        static body_t * create_body(
+            TPtrCompatible * p_ptr)
+        {
+            try
+            {
+                return new body_t(p_ptr);
+            }
+            catch (...)
+            {
+                if (p_ptr)
+                {
+                    TDeleter<TPtr>().free(p_ptr);
+                }
+                throw;
+            }
+        }
+
+        static void link(
+            body_t * p_body)
+            noexcept
+        {
+            if (p_body)
+            {
+                p_body->ref();
+                p_body->ref_ptr();
+            }
+        }
+
+        static void unlink(
+            body_t * p_body)
+            noexcept
+        {
+            if (p_body)
+            {
+                p_body->unref_ptr();
+                p_body->unref();
+            }
+        }
+
+
     public:
         inline size_t count(
             void)
             const noexcept
         {
-            return body_->get_ref_count_ptr();
+            return body_ ? body_->get_ref_count_ptr() : 0;
+        }
+
+        /**
+        * \brief Chain version, bumped after every pointer change (reset, release, exchange).
+        * Empty sync_ptr report 0, see mem::cached_reader.
+        */
+        inline size_t version(
+            std::memory_order p_order = std::memory_order_acquire)
+            const noexcept
+        {
+            return body_ ? body_->get_version(p_order) : 0;
+        }
+
+        /**
+        * \brief Pointer generation, bumped by every pointer change.
+        * Read from the pointer word itself with cc::tagged_body_layout (wraps around when packed),
+        * same as version() with other layouts. Empty sync_ptr report 0.
+        */
+        inline size_t generation(
+            std::memory_order p_order = std::memory_order_acquire)
+            const noexcept
+        {
+            return body_ ? body_->get_generation(p_order) : 0;
+        }
+
+        /**
+        * \brief Failed pointer CAS of the chain (conditional reset, release and exchange).
+        */
+        inline size_t cas_failures(
+            void)
+            const noexcept
+        {
+            return body_ ? body_->get_cas_failures() : 0;
+        }
+
+        /**
+        * \brief Bump chain version and wake waiters without changing the pointer,
+        * used to signal in place pointee updates. See mem::wait_for_change().
+        */
+        inline void notify(
+            void)
+            noexcept
+        {
+            if (body_)
+            {
+                body_->notify_version();
+            }
+        }
+
+#if defined(SYNC_PTR_BODY_POOL)
+        /**
+        * \brief Body pool statistics of this sync_ptr type.
+        */
+        static mem::pool_stats body_pool_stats(
+            void)
+        {
+            return mem::body_pool<body_t>::instance().stats();
         }
+#endif // SYNC_PTR_BODY_POOL
 
 
     public:
@@ -396,9 +1223,13 @@ namespace cc
             class TPtrCompatible>
         inline bool reset(
             TPtrCompatible * p_ptr)
-            noexcept
         {
             assert(p_ptr);
+            if (!body_)
+            {
+                body_ = create_body(p_ptr);
+                return true;
+            }
             return body_->set_ptr(p_ptr);
         }
         /**
@@ -410,9 +1241,62 @@ namespace cc
             void)
             noexcept
         {
-            return body_->reset_ptr();
+            return body_ ? body_->reset_ptr() : true;
+        }
+        /**
+        * \brief Set underlying pointer, retrying failed CAS as target contention policy allows.
+        * Free previous pointer on success.
+        * Return true on success false once the policy gives up.
+        */
+        template <
+            class TPtrCompatible,
+            class TContention>
+        inline bool reset(
+            TPtrCompatible * p_ptr,
+            TContention p_contention)
+        {
+            for (size_t attempt = 0; ; ++attempt)
+            {
+                if (reset(p_ptr))
+                {
+                    return true;
+                }
+                if (!p_contention.retry(attempt))
+                {
+                    return false;
+                }
+            }
+        }
+        /**
+        * \brief Set underlying pointer unconditionally and free previous pointer.
+        * Wait-free with atomic pointer layouts (a single exchange), lock-free with tagged ones.
+        */
+        template <
+            class TPtrCompatible>
+        inline void reset(
+            wait_free_t,
+            TPtrCompatible * p_ptr)
+        {
+            assert(p_ptr);
+            if (!body_)
+            {
+                body_ = create_body(p_ptr);
+                return;
+            }
+            body_->store_ptr(p_ptr);
+        }
+        /**
+        * \brief Set underlying pointer to null unconditionally and free previous pointer.
+        */
+        inline void reset(
+            wait_free_t)
+            noexcept
+        {
+            if (body_)
+            {
+                body_->store_ptr(nullptr);
+            }
         }
-
 
     public:
         /**
@@ -422,11 +1306,47 @@ namespace cc
         */
         inline bool release(
             TPtr ** p_out)
-            noexcept
         {
+            if (!body_)
+            {
+                *p_out = nullptr;
+                return true;
+            }
             return body_->release(p_out);
         }
         /**
+        * \brief Release, retrying failed CAS as target contention policy allows.
+        * Return true on success false once the policy gives up.
+        */
+        template <
+            class TContention>
+        inline bool release(
+            TPtr ** p_out,
+            TContention p_contention)
+        {
+            for (size_t attempt = 0; ; ++attempt)
+            {
+                // Failed attempts leave the current pointer out.
+                *p_out = nullptr;
+                if (release(p_out))
+                {
+                    return true;
+                }
+                if (!p_contention.retry(attempt))
+                {
+                    return false;
+                }
+            }
+        }
+        /**
+        * \brief Release unconditionally, return the previously owned pointer.
+        */
+        inline TPtr * release(
+            wait_free_t)
+        {
+            return body_ ? body_->exchange_ptr(nullptr) : nullptr;
+        }
+        /**
         * \brief Set managed object and return previous one.
         * Return true on success, false otherwise.
         * On failure current object is unchanged and returned one is undefined.
@@ -436,18 +1356,81 @@ namespace cc
         inline bool exchange(
             TPtr ** p_out,
             TPtrCompatible * p_ptr)
-            noexcept
         {
+            if (!body_)
+            {
+                body_ = create_body(p_ptr);
+                *p_out = nullptr;
+                return true;
+            }
             return body_->exchange(p_out, p_ptr);
         }
-
-
-    public:
-        inline TPtr * get(
-            void)
-            const noexcept
+        /**
+        * \brief Exchange, retrying failed CAS as target contention policy allows.
+        * Return true on success false once the policy gives up.
+        */
+        template <
+            class TPtrCompatible,
+            class TContention>
+        inline bool exchange(
+            TPtr ** p_out,
+            TPtrCompatible * p_ptr,
+            TContention p_contention)
+        {
+            for (size_t attempt = 0; ; ++attempt)
+            {
+                // Failed attempts leave the current pointer out.
+                *p_out = nullptr;
+                if (exchange(p_out, p_ptr))
+                {
+                    return true;
+                }
+                if (!p_contention.retry(attempt))
+                {
+                    return false;
+                }
+            }
+        }
+        /**
+        * \brief Set managed object unconditionally and return previous one.
+        */
+        template <
+            class TPtrCompatible>
+        inline TPtr * exchange(
+            wait_free_t,
+            TPtrCompatible * p_ptr)
+        {
+            if (!body_)
+            {
+                if (p_ptr)
+                {
+                    body_ = create_body(p_ptr);
+                }
+                return nullptr;
+            }
+            return body_->exchange_ptr(p_ptr);
+        }
+
+
+    public:
+        inline TPtr * get(
+            void)
+            const noexcept
+        {
+            return body_ ? body_->get_ptr() : nullptr;
+        }
+        /**
+        * \brief Get underlying pointer protected by target guard (see cc::hazard_guard).
+        * Pointer stays valid until the guard is reset or destroyed,
+        * provided the chain frees pointers through cc::hazard_deleter.
+        */
+        template<
+            class TGuard>
+        inline TPtr * get(
+            TGuard & p_guard)
+            const noexcept
         {
-            return body_->get_ptr();
+            return body_ ? body_->get_ptr(p_guard) : nullptr;
         }
 
 
@@ -466,6 +1449,34 @@ namespace cc
             return get();
         }
 
+        /**
+        * \brief Element of an array pointee.
+        */
+        inline element_type & operator[](
+            size_t p_index)
+            const noexcept
+        {
+            static_assert(
+                std::is_array<TPtr>::value,
+                "operator[] needs an array pointee.");
+            return (*get())[p_index];
+        }
+
+        /**
+        * \brief Element count of an array pointee, 0 when empty.
+        * Two calls may see two arrays while the chain is reset,
+        * size a pointer read once from get() with array_block::size() instead.
+        */
+        inline size_t size(
+            void)
+            const noexcept
+        {
+            static_assert(
+                std::is_array<TPtr>::value,
+                "size() needs an array pointee.");
+            return mem::array_block<element_type>::size(get());
+        }
+
 
     public:
         inline bool valid(
@@ -485,6 +1496,281 @@ namespace cc
     }; // class sync_ptr
 
 
+    /**
+    * \class cc::sync_ref
+    *
+    * \brief Borrowed view of a sync_ptr chain.
+    * Reads through the chain body without touching reference counts, 
+    * meant to be passed by value to short-lived calls instead of a sync_ptr.
+    * The view stays valid as long as one sync_ptr of the chain outlives it,
+    * sync() returns a full sync_ptr when the reference has to escape.
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter,
+        template <class T> class TLayout>
+    class sync_ref final
+    {
+
+    public:
+        typedef typename TPtr           pointer_type;
+        typedef typename sync_ptr<
+            TPtr,
+            TDeleter,
+            TLayout>   sync_ptr_type;
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        typedef typename sync_ptr_type::body_t body_t;
+
+    private:
+        body_t *		body_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        /**
+        * \brief Borrow target chain.
+        */
+        sync_ref(
+            sync_ptr_type const & p_ptr)
+            noexcept
+            // Members.
+            : body_(p_ptr.body_)
+        {}
+
+        sync_ref(
+            sync_ref const & p_other)
+            noexcept = default;
+
+        inline sync_ref & operator=(
+            sync_ref const & p_other)
+            noexcept = default;
+
+
+    public:
+        /**
+        * \brief Return a sync_ptr sharing the borrowed chain.
+        */
+        inline sync_ptr_type sync(
+            void)
+            const noexcept
+        {
+            return sync_ptr_type(body_);
+        }
+
+        inline size_t count(
+            void)
+            const noexcept
+        {
+            return body_ ? body_->get_ref_count_ptr() : 0;
+        }
+
+
+    public:
+        inline TPtr * get(
+            void)
+            const noexcept
+        {
+            return body_ ? body_->get_ptr() : nullptr;
+        }
+        /**
+        * \brief Get underlying pointer protected by target guard (see cc::hazard_guard).
+        */
+        template<
+            class TGuard>
+        inline TPtr * get(
+            TGuard & p_guard)
+            const noexcept
+        {
+            return body_ ? body_->get_ptr(p_guard) : nullptr;
+        }
+
+        inline TPtr & operator*(
+            void)
+            const noexcept
+        {
+            return *get();
+        }
+
+        inline TPtr * operator->(
+            void)
+            const noexcept
+        {
+            return get();
+        }
+
+
+    public:
+        inline bool valid(
+            void)
+            const noexcept
+        {
+            return (get() != nullptr);
+        }
+
+        inline operator bool(
+            void)
+            const noexcept
+        {
+            return valid();
+        }
+
+    }; // class sync_ref
+
+
+    /**
+    * \class cc::sync_weak_ptr
+    *
+    * \brief Weak reference to a sync_ptr chain.
+    * Keeps the chain body alive through its reference count but not the pointee,
+    * which is still released with the last sync_ptr of the chain.
+    * lock() returns a sync_ptr joining the chain while the pointee is alive, an empty one otherwise.
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter,
+        template <class T> class TLayout>
+    class sync_weak_ptr final
+    {
+
+    public:
+        typedef typename TPtr           pointer_type;
+        typedef typename sync_ptr<
+            TPtr,
+            TDeleter,
+            TLayout>   sync_ptr_type;
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        typedef typename sync_ptr_type::body_t body_t;
+
+    private:
+        body_t *		body_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        constexpr sync_weak_ptr(
+            void)
+            noexcept
+            // Members.
+            : body_(nullptr)
+        {}
+
+        /**
+        * \brief Observe target chain.
+        */
+        sync_weak_ptr(
+            sync_ptr_type const & p_ptr)
+            noexcept
+            // Members.
+            : body_(p_ptr.body_)
+        {
+            if (body_)
+            {
+                body_->ref();
+            }
+        }
+
+        sync_weak_ptr(
+            sync_weak_ptr && p_other)
+            noexcept
+            // Members.
+            : body_(p_other.body_)
+        {
+            p_other.body_ = nullptr;
+        }
+
+        sync_weak_ptr(
+            sync_weak_ptr const & p_other)
+            noexcept
+            // Members.
+            : body_(p_other.body_)
+        {
+            if (body_)
+            {
+                body_->ref();
+            }
+        }
+
+        ~sync_weak_ptr(
+            void)
+            noexcept
+        {
+            if (body_)
+            {
+                body_->unref();
+            }
+        }
+
+        inline sync_weak_ptr & operator=(
+            sync_weak_ptr p_other)
+            noexcept
+        {
+            swap(p_other);
+            return *this;
+        }
+
+        void swap(
+            sync_weak_ptr & p_rhs)
+            noexcept
+        {
+            auto tmp = body_;
+            body_ = p_rhs.body_;
+            p_rhs.body_ = tmp;
+        }
+
+
+    public:
+        /**
+        * \brief Return a sync_ptr joining the chain, empty if the pointee was released with its last sync_ptr.
+        * A chain emptied by release() is joined like a copy would.
+        */
+        inline sync_ptr_type lock(
+            void)
+            const noexcept
+        {
+            sync_ptr_type ptr;
+            if (body_ && body_->try_ref_ptr())
+            {
+                body_->ref();
+                ptr.body_ = body_;
+            }
+            return ptr;
+        }
+
+        inline bool expired(
+            void)
+            const noexcept
+        {
+            return !body_ || body_->get_ref_count_ptr() == 0;
+        }
+
+        inline size_t count(
+            void)
+            const noexcept
+        {
+            return body_ ? body_->get_ref_count_ptr() : 0;
+        }
+
+    }; // class sync_weak_ptr
+
+
     ///////////////////////////////////////////////////////////////////////////////////////////
     //		MAKE
     ///////////////////////////////////////////////////////////////////////////////////////////
@@ -492,28 +1778,133 @@ namespace cc
     template <
         class TPtr,
         template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class TLayout = sync_ptr_layout,
         class... TArgs>
     inline typename std::enable_if<
         !std::is_array<TPtr>::value, 
-        cc::sync_ptr<TPtr, TDeleter>>::type
+        cc::sync_ptr<TPtr, TDeleter, TLayout>>::type
         make_sync(
             TArgs&&... p_args)
     {
         typedef typename sync_ptr<
             TPtr,
-            TDeleter> sync_ptr_t;
+            TDeleter,
+            TLayout> sync_ptr_t;
         return (sync_ptr_t(new TPtr(std::forward<TArgs>(p_args)...)));
     }
 
     template <
         class TPtr,
         template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class TLayout = sync_ptr_layout,
         class... TArgs>
     typename std::enable_if<std::extent<TPtr>::value != 0, void>::type make_sync(
             TArgs&&...)
         = delete;
 
 
+    /**
+    * \brief Chain of an array of target number of value-initialized elements.
+    * Elements and their count share one allocation.
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class TLayout = sync_ptr_layout>
+    inline typename std::enable_if<
+        std::is_array<TPtr>::value && std::extent<TPtr>::value == 0, 
+        cc::sync_ptr<TPtr, TDeleter, TLayout>>::type
+        make_sync(
+            size_t p_size)
+    {
+        typedef typename sync_ptr<
+            TPtr,
+            TDeleter,
+            TLayout> sync_ptr_t;
+        typedef typename std::remove_extent<TPtr>::type element_t;
+        return (sync_ptr_t(mem::array_block<element_t>::create(p_size)));
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    //		MAKE FOR OVERWRITE
+    ///////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * \brief Chain of a default-initialized pointee, trivial types are left uninitialized.
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class TLayout = sync_ptr_layout>
+    inline typename std::enable_if<
+        !std::is_array<TPtr>::value, 
+        cc::sync_ptr<TPtr, TDeleter, TLayout>>::type
+        make_sync_for_overwrite(
+            void)
+    {
+        typedef typename sync_ptr<
+            TPtr,
+            TDeleter,
+            TLayout> sync_ptr_t;
+        return (sync_ptr_t(new TPtr));
+    }
+
+    /**
+    * \brief Chain of an array of target number of default-initialized elements,
+    * for buffers fully written before being read.
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class TLayout = sync_ptr_layout>
+    inline typename std::enable_if<
+        std::is_array<TPtr>::value && std::extent<TPtr>::value == 0, 
+        cc::sync_ptr<TPtr, TDeleter, TLayout>>::type
+        make_sync_for_overwrite(
+            size_t p_size)
+    {
+        typedef typename sync_ptr<
+            TPtr,
+            TDeleter,
+            TLayout> sync_ptr_t;
+        typedef typename std::remove_extent<TPtr>::type element_t;
+        return (sync_ptr_t(mem::array_block<element_t>::create_for_overwrite(p_size)));
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    //		MAKE IN PLACE
+    ///////////////////////////////////////////////////////////////////////////////////////////
+
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class TLayout = sync_ptr_layout,
+        class... TArgs>
+    inline typename std::enable_if<
+        !std::is_array<TPtr>::value, 
+        cc::sync_ptr<TPtr, TDeleter, TLayout>>::type
+        make_sync_inplace(
+            TArgs&&... p_args)
+    {
+        typedef typename sync_ptr<
+            TPtr,
+            TDeleter,
+            TLayout> sync_ptr_t;
+        return (sync_ptr_t(mem::inplace, std::forward<TArgs>(p_args)...));
+    }
+
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class TLayout = sync_ptr_layout,
+        class... TArgs>
+    typename std::enable_if<std::extent<TPtr>::value != 0, void>::type make_sync_inplace(
+            TArgs&&...)
+        = delete;
+
+
     ///////////////////////////////////////////////////////////////////////////////////////////
     //		MAKE WITH ALLOCATOR
     ///////////////////////////////////////////////////////////////////////////////////////////
@@ -522,17 +1913,19 @@ namespace cc
         class TPtr,
         template <class T> class TAllocator,
         template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class TLayout = sync_ptr_layout,
         class... TArgs>
     inline typename std::enable_if<
         !std::is_array<TPtr>::value, 
-        cc::sync_ptr<TPtr, TDeleter>>::type
+        cc::sync_ptr<TPtr, TDeleter, TLayout>>::type
         make_sync_with_allocator(
             TAllocator<TPtr> const & p_allocator, 
             TArgs&&... p_args)
     {
         typedef typename sync_ptr<
             TPtr,
-            TDeleter> sync_ptr_t;
+            TDeleter,
+            TLayout> sync_ptr_t;
         return (sync_ptr_t(p_allocator.allocate(std::forward<TArgs>(p_args)...)));
     }
 
@@ -540,12 +1933,66 @@ namespace cc
         class TPtr,
         template <class T> class TAllocator,
         template <class T> class TDeleter,
+        template <class T> class TLayout,
         class... TArgs>
     typename std::enable_if<std::extent<TPtr>::value != 0, void>::type make_sync_with_allocator(
         TAllocator<TPtr> const & p_allocator, 
         TArgs&&...)
         = delete;
 
+
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    //		ALLOCATE
+    ///////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * \brief Construct pointee and chain body in a single block obtained from target allocator.
+    * Works with any standard conforming allocator, like std::allocate_shared.
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class TLayout = sync_ptr_layout,
+        class TAlloc,
+        class... TArgs>
+    inline typename std::enable_if<
+        !std::is_array<TPtr>::value, 
+        cc::sync_ptr<TPtr, TDeleter, TLayout>>::type
+        allocate_sync(
+            TAlloc const & p_alloc, 
+            TArgs&&... p_args)
+    {
+        typedef typename sync_ptr<
+            TPtr,
+            TDeleter,
+            TLayout> sync_ptr_t;
+        return (sync_ptr_t(std::allocator_arg, p_alloc, std::forward<TArgs>(p_args)...));
+    }
+
+#if defined(SYNC_PTR_PMR)
+    /**
+    * \brief Construct pointee and chain body from target memory resource.
+    * Uses-allocator pointees (std::pmr containers) allocate from the same resource.
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class TLayout = sync_ptr_layout,
+        class TResource,
+        class... TArgs>
+    inline typename std::enable_if<
+        !std::is_array<TPtr>::value && std::is_base_of<std::pmr::memory_resource, TResource>::value, 
+        cc::sync_ptr<TPtr, TDeleter, TLayout>>::type
+        make_sync(
+            TResource * p_resource, 
+            TArgs&&... p_args)
+    {
+        return (allocate_sync<TPtr, TDeleter, TLayout>(
+            std::pmr::polymorphic_allocator<TPtr>(p_resource), 
+            std::forward<TArgs>(p_args)...));
+    }
+#endif // SYNC_PTR_PMR
+
 } // namespace cc
 
 
@@ -554,10 +2001,11 @@ namespace std
     
     template <
         class TPtr,
-        template <class T> class TDeleter>
+        template <class T> class TDeleter,
+        template <class T> class TLayout>
     inline void swap(
-        cc::sync_ptr<TPtr, TDeleter> & p_lhs,
-        cc::sync_ptr<TPtr, TDeleter> & p_rhs)
+        cc::sync_ptr<TPtr, TDeleter, TLayout> & p_lhs,
+        cc::sync_ptr<TPtr, TDeleter, TLayout> & p_rhs)
         noexcept(noexcept(p_lhs.swap(p_rhs)))
     {
         p_lhs.swap(p_rhs);
@@ -573,11 +2021,13 @@ namespace std
 template<
     class TPtr1,
     template <class T> class TDeleter1,
+    template <class T> class TLayout1,
     class TPtr2,
-    template <class T> class TDeleter2>
+    template <class T> class TDeleter2,
+    template <class T> class TLayout2>
 inline bool operator==(
-    cc::sync_ptr<TPtr1, TDeleter1> const & p_lhs,
-    cc::sync_ptr<TPtr2, TDeleter2> const & p_rhs)
+    cc::sync_ptr<TPtr1, TDeleter1, TLayout1> const & p_lhs,
+    cc::sync_ptr<TPtr2, TDeleter2, TLayout2> const & p_rhs)
     noexcept
 {	
     return (p_lhs.get() == p_rhs.get());
@@ -586,11 +2036,13 @@ inline bool operator==(
 template<
     class TPtr1,
     template <class T> class TDeleter1,
+    template <class T> class TLayout1,
     class TPtr2,
-    template <class T> class TDeleter2>
+    template <class T> class TDeleter2,
+    template <class T> class TLayout2>
 inline bool operator!=(
-    cc::sync_ptr<TPtr1, TDeleter1> const & p_lhs,
-    cc::sync_ptr<TPtr2, TDeleter2> const & p_rhs)
+    cc::sync_ptr<TPtr1, TDeleter1, TLayout1> const & p_lhs,
+    cc::sync_ptr<TPtr2, TDeleter2, TLayout2> const & p_rhs)
     noexcept
 {
     return (!(p_lhs == p_rhs));
@@ -599,14 +2051,16 @@ inline bool operator!=(
 template<
     class TPtr1,
     template <class T> class TDeleter1,
+    template <class T> class TLayout1,
     class TPtr2,
-    template <class T> class TDeleter2>
+    template <class T> class TDeleter2,
+    template <class T> class TLayout2>
 inline bool operator<(
-    cc::sync_ptr<TPtr1, TDeleter1> const & p_lhs,
-    cc::sync_ptr<TPtr2, TDeleter2> const & p_rhs)
+    cc::sync_ptr<TPtr1, TDeleter1, TLayout1> const & p_lhs,
+    cc::sync_ptr<TPtr2, TDeleter2, TLayout2> const & p_rhs)
 {	
-    typedef typename cc::sync_ptr<TPtr1, TDeleter1>::pointer ptr1_t;
-    typedef typename cc::sync_ptr<TPtr2, TDeleter2>::pointer ptr2_t;
+    typedef typename cc::sync_ptr<TPtr1, TDeleter1, TLayout1>::pointer ptr1_t;
+    typedef typename cc::sync_ptr<TPtr2, TDeleter2, TLayout2>::pointer ptr2_t;
     typedef typename std::common_type<ptr1_t, ptr2_t>::type common_t;
     return (std::less<common_t>()(p_lhs.get(), p_rhs.get()));
 }
@@ -614,11 +2068,13 @@ inline bool operator<(
 template<
     class TPtr1,
     template <class T> class TDeleter1,
+    template <class T> class TLayout1,
     class TPtr2,
-    template <class T> class TDeleter2>
+    template <class T> class TDeleter2,
+    template <class T> class TLayout2>
 inline bool operator>=(
-    cc::sync_ptr<TPtr1, TDeleter1> const & p_lhs,
-    cc::sync_ptr<TPtr2, TDeleter2> const & p_rhs)
+    cc::sync_ptr<TPtr1, TDeleter1, TLayout1> const & p_lhs,
+    cc::sync_ptr<TPtr2, TDeleter2, TLayout2> const & p_rhs)
 {	
     return (!(p_lhs < p_rhs));
 }
@@ -626,11 +2082,13 @@ inline bool operator>=(
 template<
     class TPtr1,
     template <class T> class TDeleter1,
+    template <class T> class TLayout1,
     class TPtr2,
-    template <class T> class TDeleter2>
+    template <class T> class TDeleter2,
+    template <class T> class TLayout2>
 inline bool operator>(
-    cc::sync_ptr<TPtr1, TDeleter1> const & p_lhs,
-    cc::sync_ptr<TPtr2, TDeleter2> const & p_rhs)
+    cc::sync_ptr<TPtr1, TDeleter1, TLayout1> const & p_lhs,
+    cc::sync_ptr<TPtr2, TDeleter2, TLayout2> const & p_rhs)
 {	
     return (p_rhs < p_lhs);
 }
@@ -638,11 +2096,13 @@ inline bool operator>(
 template<
     class TPtr1,
     template <class T> class TDeleter1,
+    template <class T> class TLayout1,
     class TPtr2,
-    template <class T> class TDeleter2>
+    template <class T> class TDeleter2,
+    template <class T> class TLayout2>
 inline bool operator<=(
-    cc::sync_ptr<TPtr1, TDeleter1> const & p_lhs,
-    cc::sync_ptr<TPtr2, TDeleter2> const & p_rhs)
+    cc::sync_ptr<TPtr1, TDeleter1, TLayout1> const & p_lhs,
+    cc::sync_ptr<TPtr2, TDeleter2, TLayout2> const & p_rhs)
 {	
     return (!(p_rhs < p_lhs));
 }
@@ -651,9 +2111,10 @@ inline bool operator<=(
 
 template<
     class TPtr,
-    template <class T> class TDeleter >
+    template <class T> class TDeleter,
+    template <class T> class TLayout >
 inline bool operator==(
-    cc::sync_ptr<TPtr, TDeleter> const & p_lhs,
+    cc::sync_ptr<TPtr, TDeleter, TLayout> const & p_lhs,
     std::nullptr_t) 
     noexcept
 {	
@@ -662,10 +2123,11 @@ inline bool operator==(
 
 template<
     class TPtr,
-    template <class T> class TDeleter >
+    template <class T> class TDeleter,
+    template <class T> class TLayout >
 inline bool operator==(
     std::nullptr_t,
-    cc::sync_ptr<TPtr, TDeleter> const & p_rhs)
+    cc::sync_ptr<TPtr, TDeleter, TLayout> const & p_rhs)
     noexcept
 {	
     return (!p_rhs);
@@ -673,9 +2135,10 @@ inline bool operator==(
 
 template<
     class TPtr,
-    template <class T> class TDeleter >
+    template <class T> class TDeleter,
+    template <class T> class TLayout >
 inline bool operator!=(
-    cc::sync_ptr<TPtr, TDeleter> const & p_lhs,
+    cc::sync_ptr<TPtr, TDeleter, TLayout> const & p_lhs,
     std::nullptr_t p_rhs) 
     noexcept
 {	
@@ -684,10 +2147,11 @@ inline bool operator!=(
 
 template<
     class TPtr,
-    template <class T> class TDeleter >
+    template <class T> class TDeleter,
+    template <class T> class TLayout >
 inline bool operator!=(
     std::nullptr_t p_lhs,
-    cc::sync_ptr<TPtr, TDeleter> const & p_rhs)
+    cc::sync_ptr<TPtr, TDeleter, TLayout> const & p_rhs)
     noexcept
 {	
     return (!(p_lhs == p_rhs));
@@ -695,31 +2159,34 @@ inline bool operator!=(
 
 template<
     class TPtr,
-    template <class T> class TDeleter >
+    template <class T> class TDeleter,
+    template <class T> class TLayout >
 inline bool operator<(
-    cc::sync_ptr<TPtr, TDeleter> const & p_lhs,
+    cc::sync_ptr<TPtr, TDeleter, TLayout> const & p_lhs,
     std::nullptr_t p_rhs)
 {	
-    typedef typename cc::sync_ptr<TPtr, TDeleter>::pointer _Ptr;
+    typedef typename cc::sync_ptr<TPtr, TDeleter, TLayout>::pointer _Ptr;
     return (std::less<_Ptr>()(p_lhs.get(), p_rhs));
 }
 
 template<
     class TPtr,
-    template <class T> class TDeleter >
+    template <class T> class TDeleter,
+    template <class T> class TLayout >
 inline bool operator<(
     std::nullptr_t p_lhs,
-    cc::sync_ptr<TPtr, TDeleter> const & p_rhs)
+    cc::sync_ptr<TPtr, TDeleter, TLayout> const & p_rhs)
 {	
-    typedef typename cc::sync_ptr<TPtr, TDeleter>::pointer _Ptr;
+    typedef typename cc::sync_ptr<TPtr, TDeleter, TLayout>::pointer _Ptr;
     return (std::less<_Ptr>()(p_lhs, p_rhs.get()));
 }
 
 template<
     class TPtr,
-    template <class T> class TDeleter >
+    template <class T> class TDeleter,
+    template <class T> class TLayout >
 inline bool operator>=(
-    cc::sync_ptr<TPtr, TDeleter> const & p_lhs,
+    cc::sync_ptr<TPtr, TDeleter, TLayout> const & p_lhs,
     std::nullptr_t p_rhs)
 {	
     return (!(p_lhs < p_rhs));
@@ -727,19 +2194,21 @@ inline bool operator>=(
 
 template<
     class TPtr,
-    template <class T> class TDeleter >
+    template <class T> class TDeleter,
+    template <class T> class TLayout >
 inline bool operator>=(
     std::nullptr_t p_lhs,
-    cc::sync_ptr<TPtr, TDeleter> const & p_rhs)
+    cc::sync_ptr<TPtr, TDeleter, TLayout> const & p_rhs)
 {	
     return (!(p_lhs < p_rhs));
 }
 
 template<
     class TPtr,
-    template <class T> class TDeleter >
+    template <class T> class TDeleter,
+    template <class T> class TLayout >
 inline bool operator>(
-    cc::sync_ptr<TPtr, TDeleter> const & p_lhs,
+    cc::sync_ptr<TPtr, TDeleter, TLayout> const & p_lhs,
     std::nullptr_t p_rhs)
 {	
     return (p_rhs < p_lhs);
@@ -747,19 +2216,21 @@ inline bool operator>(
 
 template<
     class TPtr,
-    template <class T> class TDeleter >
+    template <class T> class TDeleter,
+    template <class T> class TLayout >
 inline bool operator>(
     std::nullptr_t p_lhs,
-    cc::sync_ptr<TPtr, TDeleter> const & p_rhs)
+    cc::sync_ptr<TPtr, TDeleter, TLayout> const & p_rhs)
 {	
     return (p_rhs < p_lhs);
 }
 
 template<
     class TPtr,
-    template <class T> class TDeleter >
+    template <class T> class TDeleter,
+    template <class T> class TLayout >
 inline bool operator<=(
-    cc::sync_ptr<TPtr, TDeleter> const & p_lhs,
+    cc::sync_ptr<TPtr, TDeleter, TLayout> const & p_lhs,
     std::nullptr_t p_rhs)
 {	
     return (!(p_rhs < p_lhs));
@@ -767,10 +2238,11 @@ inline bool operator<=(
 
 template<
     class TPtr,
-    template <class T> class TDeleter >
+    template <class T> class TDeleter,
+    template <class T> class TLayout >
 inline bool operator<=(
     std::nullptr_t p_lhs,
-    cc::sync_ptr<TPtr, TDeleter> const & p_rhs)
+    cc::sync_ptr<TPtr, TDeleter, TLayout> const & p_rhs)
 {	
     return (!(p_rhs < p_lhs));
 }
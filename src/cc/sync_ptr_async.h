@@ -0,0 +1,73 @@
+
+#ifndef __CC_SYNC_PTR_ASYNC_H__
+#define __CC_SYNC_PTR_ASYNC_H__
+
+#include <future>
+#include <utility>
+
+#ifndef __CC_SYNC_PTR_H__
+#include "cc/sync_ptr.h"
+#endif
+
+#ifndef __MEMORY_SYNC_PTR_ASYNC_H__
+#include "mem/sync_ptr_async.h"
+#endif
+
+
+namespace cc
+{
+
+    /**
+    * \brief Build a new pointer on target executor and publish it to target chain once built,
+    * readers keep the current pointer until it is published. See mem::post_reset().
+    * Publishing is unconditional (see wait_free_t), it can't fail under contention like reset().
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter,
+        template <class T> class TLayout,
+        class TExecutor,
+        class TFactory>
+    std::future<bool> reset_async(
+        sync_ptr<TPtr, TDeleter, TLayout> const & p_chain,
+        TExecutor & p_executor,
+        TFactory && p_factory)
+    {
+        return mem::post_reset(
+            p_chain,
+            p_executor,
+            std::forward<TFactory>(p_factory),
+            [](sync_ptr<TPtr, TDeleter, TLayout> & p_target, TPtr * p_ptr)
+            {
+                if (p_ptr)
+                {
+                    p_target.reset(wait_free, p_ptr);
+                }
+                else
+                {
+                    p_target.reset(wait_free);
+                }
+            });
+    }
+
+    /**
+    * \brief Build a new pointer on the process wide mem::async_pool, see above.
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter,
+        template <class T> class TLayout,
+        class TFactory>
+    std::future<bool> reset_async(
+        sync_ptr<TPtr, TDeleter, TLayout> const & p_chain,
+        TFactory && p_factory)
+    {
+        return reset_async(
+            p_chain,
+            mem::async_pool::instance(),
+            std::forward<TFactory>(p_factory));
+    }
+
+} // namespace cc
+
+#endif // __CC_SYNC_PTR_ASYNC_H__
@@ -0,0 +1,144 @@
+
+#ifndef __CC_SYNC_PTR_CONTENTION_H__
+#define __CC_SYNC_PTR_CONTENTION_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+
+namespace cc
+{
+
+    /**
+    * \brief Spin-wait hint to the cpu (pause, yield), nothing where unavailable.
+    */
+    inline void cpu_relax(
+        void)
+        noexcept
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+
+    // Contention policies of the conditional cc::sync_ptr reset(), release() and exchange().
+    // retry() is called after the p_attempt-th failed CAS (from 0), it waits as the policy wants
+    // and returns false to give up, the operation then returns false.
+
+    /**
+    * \brief Give up after the first failure, the plain conditional operations behavior.
+    */
+    struct single_attempt
+    {
+        inline bool retry(
+            size_t)
+            const noexcept
+        {
+            return false;
+        }
+
+    }; // struct single_attempt
+
+    /**
+    * \brief Retry at once, up to target number of attempts.
+    */
+    struct bounded_retry
+    {
+        size_t      attempts_;
+
+        explicit bounded_retry(
+            size_t p_attempts = 16U)
+            noexcept
+            : attempts_(p_attempts)
+        {}
+
+        inline bool retry(
+            size_t p_attempt)
+            const noexcept
+        {
+            return p_attempt + 1U < attempts_;
+        }
+
+    }; // struct bounded_retry
+
+    /**
+    * \brief Yield the thread between attempts, up to target number of attempts.
+    */
+    struct yield_retry
+    {
+        size_t      attempts_;
+
+        explicit yield_retry(
+            size_t p_attempts = 16U)
+            noexcept
+            : attempts_(p_attempts)
+        {}
+
+        inline bool retry(
+            size_t p_attempt)
+            const noexcept
+        {
+            if (p_attempt + 1U >= attempts_)
+            {
+                return false;
+            }
+            std::this_thread::yield();
+            return true;
+        }
+
+    }; // struct yield_retry
+
+    /**
+    * \brief Spin 1, 2, 4... cpu_relax() between attempts up to a ceiling, then yield,
+    * up to target number of attempts.
+    */
+    struct exponential_backoff
+    {
+        size_t      attempts_;
+        size_t      max_spins_;
+
+        explicit exponential_backoff(
+            size_t p_attempts = 64U,
+            size_t p_max_spins = 1024U)
+            noexcept
+            : attempts_(p_attempts)
+            , max_spins_(p_max_spins)
+        {}
+
+        inline bool retry(
+            size_t p_attempt)
+            const noexcept
+        {
+            if (p_attempt + 1U >= attempts_)
+            {
+                return false;
+            }
+            auto shift = (std::min)(p_attempt, size_t(30U));
+            auto spins = size_t(1U) << shift;
+            if (spins > max_spins_)
+            {
+                std::this_thread::yield();
+                return true;
+            }
+            for (size_t i = 0; i < spins; ++i)
+            {
+                cpu_relax();
+            }
+            return true;
+        }
+
+    }; // struct exponential_backoff
+
+} // namespace cc
+
+#endif // __CC_SYNC_PTR_CONTENTION_H__
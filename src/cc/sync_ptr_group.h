@@ -0,0 +1,251 @@
+
+#ifndef __CC_SYNC_PTR_GROUP_H__
+#define __CC_SYNC_PTR_GROUP_H__
+
+#include <cassert>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#ifndef __CC_SYNC_PTR_H__
+#include "cc/sync_ptr.h"
+#endif
+
+
+namespace cc
+{
+
+    /**
+    * \class cc::sync_group
+    *
+    * \brief Transactional update of several sync_ptr chains.
+    * stage() records a new pointer for a chain, commit() publishes every staged pointer at once
+    * and frees previous pointers.
+    * Commits are framed by a process wide sequence (seqlock), snapshot() retries until it
+    * reads every chain between two commits, so it never sees a mix of previous and committed pointers.
+    *
+    * Chains may have different pointee types.
+    * Commits of different groups are serialized, concurrent snapshot() and get() calls never block them.
+    * A chain staged twice ends up with its last staged pointer.
+    * Pointers staged but not committed are freed with the group.
+    *
+    * \note Like get(), snapshot() pointers are only protected from later updates by the deleter policy.
+    */
+    class sync_group final
+    {
+
+    private:
+        /**
+        * \brief Type erased staged update.
+        */
+        class entry
+        {
+
+        public:
+            virtual ~entry(
+                void)
+            {}
+
+            /**
+            * \brief Publish staged pointer, keep previous one.
+            */
+            virtual void publish(
+                void)
+                noexcept = 0;
+
+        }; // class entry
+
+        template<
+            class TSyncPtr>
+        class typed_entry final
+            : public entry
+        {
+
+        private:
+            typedef typename TSyncPtr::pointer_type pointer_t;
+
+        private:
+            TSyncPtr        chain_;
+            pointer_t *     ptr_;
+
+        public:
+            typed_entry(
+                TSyncPtr const & p_chain,
+                pointer_t * p_ptr)
+                noexcept
+                // Members.
+                : chain_(p_chain)
+                , ptr_(p_ptr)
+            {}
+
+            /**
+            * \brief Free staged pointer if never published, previous one otherwise.
+            */
+            ~typed_entry(
+                void)
+            {
+                chain_.body_->retire_ptr(ptr_);
+            }
+
+            void publish(
+                void)
+                noexcept override
+            {
+                ptr_ = chain_.body_->swap_ptr(ptr_);
+            }
+
+        }; // class typed_entry
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        std::vector<std::unique_ptr<entry>>     entries_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        sync_group(sync_group const &) = delete;
+        void operator=(sync_group const &) = delete;
+
+    public:
+        sync_group(
+            void) = default;
+
+        sync_group(
+            sync_group &&) = default;
+
+        sync_group & operator=(
+            sync_group &&) = default;
+
+
+    public:
+        /**
+        * \brief Stage target pointer for target chain.
+        * The group takes ownership of the pointer and keeps the chain alive until commit.
+        */
+        template <
+            class TPtr,
+            template <class T> class TDeleter,
+            template <class T> class TLayout,
+            class TPtrCompatible>
+        void stage(
+            sync_ptr<TPtr, TDeleter, TLayout> const & p_chain,
+            TPtrCompatible * p_ptr)
+        {
+            typedef sync_ptr<TPtr, TDeleter, TLayout> sync_ptr_t;
+
+            assert(p_chain.body_);
+            std::unique_ptr<entry> e;
+            try
+            {
+                e.reset(new typed_entry<sync_ptr_t>(p_chain, p_ptr));
+                entries_.reserve(entries_.size() + 1U);
+            }
+            catch (...)
+            {
+                if (!e)
+                {
+                    p_chain.body_->retire_ptr(p_ptr);
+                }
+                throw;
+            }
+            entries_.push_back(std::move(e));
+        }
+
+        /**
+        * \brief Publish every staged pointer, free previous ones and clear the group.
+        */
+        void commit(
+            void)
+            noexcept
+        {
+            auto & seq = sequence();
+            auto s = seq.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                if (!(s & 1U) && seq.compare_exchange_weak(
+                    s,
+                    s + 1U,
+                    std::memory_order_acquire,
+                    std::memory_order_relaxed))
+                {
+                    break;
+                }
+                if (s & 1U)
+                {
+                    std::this_thread::yield();
+                    s = seq.load(std::memory_order_relaxed);
+                }
+            }
+
+            for (auto & e : entries_)
+            {
+                e->publish();
+            }
+            seq.store(s + 2U, std::memory_order_release);
+
+            entries_.clear();
+        }
+
+        inline size_t size(
+            void)
+            const noexcept
+        {
+            return entries_.size();
+        }
+
+
+    public:
+        /**
+        * \brief Read pointers of target chains consistently with commit().
+        */
+        template<
+            class... TSyncPtr>
+        static std::tuple<typename TSyncPtr::pointer_type *...> snapshot(
+            TSyncPtr const &... p_chains)
+            noexcept
+        {
+            auto & seq = sequence();
+            for (;;)
+            {
+                auto s = seq.load(std::memory_order_acquire);
+                if (!(s & 1U))
+                {
+                    auto ptrs = std::make_tuple(p_chains.get()...);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (seq.load(std::memory_order_relaxed) == s)
+                    {
+                        return ptrs;
+                    }
+                }
+                std::this_thread::yield();
+            }
+        }
+
+
+    private:
+        /**
+        * \brief Commit sequence, odd while a commit publishes.
+        */
+        static std::atomic<size_t> & sequence(
+            void)
+            noexcept
+        {
+            static std::atomic<size_t> seq(0);
+            return seq;
+        }
+
+    }; // class sync_group
+
+} // namespace cc
+
+#endif // __CC_SYNC_PTR_GROUP_H__
@@ -0,0 +1,544 @@
+
+#ifndef __CC_SYNC_PTR_HAZARD_H__
+#define __CC_SYNC_PTR_HAZARD_H__
+
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#ifndef __CC_SYNC_PTR_H__
+#include "cc/sync_ptr.h"
+#endif
+
+
+namespace cc
+{
+
+    /**
+    * \class cc::hazard_domain
+    *
+    * \brief Hazard pointer registry.
+    * Reader threads publish the pointers they dereference in per-thread hazard slots.
+    * Retired pointers are freed once no hazard slot protects them anymore.
+    */
+    class hazard_domain final
+    {
+
+    public:
+        typedef void (*free_t)(void *);
+
+        /** \brief Hazard slots available per thread. */
+        static constexpr size_t slot_count = 8U;
+
+        /** \brief Minimum retired pointers count triggering a scan. */
+        static constexpr size_t scan_threshold = 64U;
+
+
+    private:
+        struct retired
+        {
+            void *      ptr_;
+            free_t      free_;
+        };
+
+        /**
+        * \brief Per-thread hazard slots and retire list.
+        * Records are never freed before the domain, inactive ones are recycled.
+        */
+        struct record
+        {
+            std::atomic<void const *>   slots_[slot_count];
+            std::atomic<bool>           active_;
+            record *                    next_;
+            size_t                      used_;
+            std::vector<retired>        retired_;
+
+            record(
+                void)
+                noexcept
+                : active_(true)
+                , next_(nullptr)
+                , used_(0)
+            {
+                for (auto & slot : slots_)
+                {
+                    slot.store(nullptr, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        /**
+        * \brief Thread record owner, gives the record back on thread exit.
+        */
+        struct local
+        {
+            hazard_domain &     domain_;
+            record *            record_;
+
+            explicit local(
+                hazard_domain & p_domain)
+                : domain_(p_domain)
+                , record_(p_domain.acquire_record())
+            {}
+
+            ~local(
+                void)
+            {
+                domain_.release_record(record_);
+            }
+        };
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        std::atomic<record *>       head_;
+        std::atomic<size_t>         record_count_;
+        std::mutex                  orphans_mtx_;
+        std::vector<retired>        orphans_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        hazard_domain(hazard_domain const &) = delete;
+        hazard_domain(hazard_domain &&) = delete;
+        void operator=(hazard_domain const &) = delete;
+        void operator=(hazard_domain &&) = delete;
+
+    private:
+        hazard_domain(
+            void)
+            noexcept
+            : head_(nullptr)
+            , record_count_(0)
+        {}
+
+    public:
+        ~hazard_domain(
+            void)
+        {
+            auto * rec = head_.load();
+            while (rec)
+            {
+                auto * next = rec->next_;
+                free_all(rec->retired_);
+                delete rec;
+                rec = next;
+            }
+            free_all(orphans_);
+        }
+
+        static hazard_domain & instance(
+            void)
+        {
+            static hazard_domain domain;
+            return domain;
+        }
+
+
+    public:
+        /**
+        * \brief Reserve a hazard slot of the calling thread.
+        * Throw std::length_error if the thread already holds slot_count slots.
+        */
+        std::atomic<void const *> * acquire_slot(
+            void)
+        {
+            auto * rec = local_record();
+            for (size_t i = 0; i < slot_count; ++i)
+            {
+                if (!(rec->used_ & (size_t(1U) << i)))
+                {
+                    rec->used_ |= (size_t(1U) << i);
+                    return &rec->slots_[i];
+                }
+            }
+            throw std::length_error("Hazard slots exhausted on calling thread.");
+        }
+
+        /**
+        * \brief Give back a hazard slot of the calling thread.
+        */
+        void release_slot(
+            std::atomic<void const *> * p_slot)
+            noexcept
+        {
+            auto * rec = local_record();
+            auto i = static_cast<size_t>(p_slot - rec->slots_);
+            assert(i < slot_count);
+            p_slot->store(nullptr, std::memory_order_release);
+            rec->used_ &= ~(size_t(1U) << i);
+        }
+
+
+    public:
+        /**
+        * \brief Defer free of target pointer until no hazard slot protects it.
+        * When the retire list can't grow, waits for other threads to stop protecting it
+        * and frees it in place, the calling thread must not protect it.
+        */
+        template<
+            class TType>
+        void retire(
+            TType * p_ptr)
+            noexcept
+        {
+            retire(
+                const_cast<typename std::remove_cv<TType>::type *>(p_ptr),
+                &delete_ptr<typename std::remove_cv<TType>::type>);
+        }
+
+        void retire(
+            void * p_ptr,
+            free_t p_free)
+            noexcept
+        {
+            record * rec = nullptr;
+            try
+            {
+                rec = local_record();
+                rec->retired_.push_back(retired{ p_ptr, p_free });
+            }
+            catch (...)
+            {
+                // No record (first use of the thread) or no room in its retire list.
+                wait_unprotected(rec, p_ptr);
+                p_free(p_ptr);
+                return;
+            }
+            if (rec->retired_.size() >= threshold())
+            {
+                scan(rec);
+            }
+        }
+
+        /**
+        * \brief Free every retired pointer no longer protected.
+        */
+        void reclaim(
+            void)
+            noexcept
+        {
+            scan(local_record());
+        }
+
+        /**
+        * \brief Number of retired pointers awaiting reclamation on the calling thread.
+        */
+        size_t pending(
+            void)
+        {
+            return local_record()->retired_.size();
+        }
+
+
+    private:
+        template<
+            class TType>
+        static void delete_ptr(
+            void * p_ptr)
+        {
+            delete static_cast<TType *>(p_ptr);
+        }
+
+        static void free_all(
+            std::vector<retired> & p_list)
+            noexcept
+        {
+            for (auto & r : p_list)
+            {
+                r.free_(r.ptr_);
+            }
+            p_list.clear();
+        }
+
+        size_t threshold(
+            void)
+            const noexcept
+        {
+            return (std::max)(
+                scan_threshold,
+                2U * slot_count * record_count_.load(std::memory_order_relaxed));
+        }
+
+        record * local_record(
+            void)
+        {
+            static thread_local local l(*this);
+            return l.record_;
+        }
+
+        record * acquire_record(
+            void)
+        {
+            for (auto * rec = head_.load(); rec; rec = rec->next_)
+            {
+                bool active = false;
+                if (!rec->active_.load(std::memory_order_relaxed) &&
+                    rec->active_.compare_exchange_strong(active, true))
+                {
+                    return rec;
+                }
+            }
+
+            auto * rec = new record();
+            auto * head = head_.load();
+            do
+            {
+                rec->next_ = head;
+            } while (!head_.compare_exchange_weak(head, rec));
+            record_count_.fetch_add(1U, std::memory_order_relaxed);
+            return rec;
+        }
+
+        /**
+        * \brief Wait until no hazard slot protects target pointer, without allocating.
+        * Target record is the calling thread one, null if it has none.
+        */
+        void wait_unprotected(
+            record * p_record,
+            void const * p_ptr)
+            noexcept
+        {
+            for (auto * rec = head_.load(); rec; )
+            {
+                bool hazard = false;
+                for (auto & slot : rec->slots_)
+                {
+                    hazard |= (slot.load() == p_ptr);
+                }
+                if (!hazard)
+                {
+                    rec = rec->next_;
+                    continue;
+                }
+                assert(rec != p_record && "Retired pointer is protected by the calling thread.");
+                std::this_thread::yield();
+            }
+        }
+
+        void release_record(
+            record * p_record)
+            noexcept
+        {
+            for (auto & slot : p_record->slots_)
+            {
+                slot.store(nullptr, std::memory_order_release);
+            }
+            p_record->used_ = 0;
+
+            scan(p_record);
+            if (!p_record->retired_.empty())
+            {
+                // Out of memory, the record keeps them for its next owner.
+                std::lock_guard<std::mutex> l(orphans_mtx_);
+                try
+                {
+                    orphans_.insert(
+                        orphans_.end(),
+                        p_record->retired_.begin(),
+                        p_record->retired_.end());
+                    p_record->retired_.clear();
+                }
+                catch (...)
+                {}
+            }
+            p_record->active_.store(false, std::memory_order_release);
+        }
+
+        void scan(
+            record * p_record)
+            noexcept
+        {
+            // Adopt pointers left behind by exited threads.
+            if (orphans_mtx_.try_lock())
+            {
+                try
+                {
+                    p_record->retired_.insert(
+                        p_record->retired_.end(),
+                        orphans_.begin(),
+                        orphans_.end());
+                    orphans_.clear();
+                }
+                catch (...)
+                {}
+                orphans_mtx_.unlock();
+            }
+
+            // Out of memory, retired pointers wait for the next scan.
+            std::vector<void const *> hazards;
+            std::vector<retired> unprotected;
+            try
+            {
+                hazards.reserve(slot_count * record_count_.load(std::memory_order_relaxed));
+                for (auto * rec = head_.load(); rec; rec = rec->next_)
+                {
+                    for (auto & slot : rec->slots_)
+                    {
+                        auto * p = slot.load();
+                        if (p)
+                        {
+                            hazards.push_back(p);
+                        }
+                    }
+                }
+                std::sort(hazards.begin(), hazards.end());
+
+                auto & list = p_record->retired_;
+                auto it = std::partition(
+                    list.begin(),
+                    list.end(),
+                    [&hazards](retired const & r)
+                    {
+                        return std::binary_search(hazards.begin(), hazards.end(), r.ptr_);
+                    });
+                unprotected.assign(it, list.end());
+                list.erase(it, list.end());
+            }
+            catch (...)
+            {
+                return;
+            }
+            free_all(unprotected);
+        }
+
+    }; // class hazard_domain
+
+
+    /**
+    * \class cc::hazard_guard
+    *
+    * \brief Owns one hazard slot of the calling thread.
+    * The pointer returned by protect() stays valid until the guard is reset or destroyed.
+    * Guards are bound to the thread that created them.
+    */
+    class hazard_guard final
+    {
+
+    private:
+        std::atomic<void const *> *     slot_;
+
+    public:
+        hazard_guard(hazard_guard const &) = delete;
+        hazard_guard(hazard_guard &&) = delete;
+        void operator=(hazard_guard const &) = delete;
+        void operator=(hazard_guard &&) = delete;
+
+    public:
+        /**
+        * \brief Throw std::length_error if the calling thread already holds hazard_domain::slot_count guards.
+        */
+        hazard_guard(
+            void)
+            : slot_(hazard_domain::instance().acquire_slot())
+        {}
+
+        ~hazard_guard(
+            void)
+            noexcept
+        {
+            hazard_domain::instance().release_slot(slot_);
+        }
+
+    public:
+        /**
+        * \brief Load and protect target pointer.
+        * Publishes the pointer then validates it is still the current one.
+        */
+        template<
+            class TAtomic>
+        inline auto protect(
+            TAtomic const & p_src)
+            noexcept -> decltype(p_src.load())
+        {
+            auto * p = p_src.load();
+            for (;;)
+            {
+                slot_->store(p);
+                auto * q = p_src.load();
+                if (q == p)
+                {
+                    return p;
+                }
+                p = q;
+            }
+        }
+
+        /**
+        * \brief Stop protecting current pointer.
+        */
+        inline void reset(
+            void)
+            noexcept
+        {
+            slot_->store(nullptr, std::memory_order_release);
+        }
+
+    }; // class hazard_guard
+
+
+    /**
+    * \brief Hazard pointer deleter used by smart pointer(s).
+    * Retires pointer to the hazard domain, "delete" is called once no reader protects it.
+    */
+    template<
+        class TType>
+    struct hazard_deleter
+    {
+        constexpr hazard_deleter(
+            void)
+            noexcept = default;
+
+        template<
+            class TType2,
+            class = typename std::enable_if<std::is_convertible<TType2 *, TType *>::value, void>::type>
+            hazard_deleter(hazard_deleter<TType2> const &)
+            noexcept
+        {}
+
+        void free(
+            TType * p_ptr)
+            const noexcept
+        {
+            static_assert(
+                0 < sizeof(TType),
+                "can't delete an incomplete type");
+            hazard_domain::instance().retire(p_ptr);
+        }
+
+    }; // struct hazard_deleter
+
+
+    template<class TPtr>
+    using hazard_sync_ptr = sync_ptr<TPtr, hazard_deleter>;
+
+
+    /**
+    * \brief Retire a pointer obtained from release() or exchange() on a hazard protected chain.
+    */
+    template<
+        class TPtr>
+    inline void hazard_retire(
+        TPtr * p_ptr)
+        noexcept
+    {
+        if (p_ptr)
+        {
+            hazard_domain::instance().retire(p_ptr);
+        }
+    }
+
+} // namespace cc
+
+#endif // __CC_SYNC_PTR_HAZARD_H__
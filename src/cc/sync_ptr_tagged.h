@@ -0,0 +1,322 @@
+
+#ifndef __CC_SYNC_PTR_TAGGED_H__
+#define __CC_SYNC_PTR_TAGGED_H__
+
+#include <cassert>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 16 bytes CAS: cmpxchg16b, needs -mcx16 with gcc and clang.
+// SYNC_PTR_DWCAS=1 or 0 picks the layout and must be the same in every translation unit
+// (the CMake option SYNC_PTR_DWCAS defines it for all targets). Left undefined it follows
+// the compiler flags, SYNC_PTR_NO_DWCAS turns it off.
+#if !defined(SYNC_PTR_DWCAS)
+#if defined(SYNC_PTR_NO_DWCAS)
+#define SYNC_PTR_DWCAS 0
+#elif defined(__x86_64__) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+#define SYNC_PTR_DWCAS 1
+#elif defined(_MSC_VER) && defined(_M_X64)
+#define SYNC_PTR_DWCAS 1
+#else
+#define SYNC_PTR_DWCAS 0
+#endif
+#endif
+
+#if SYNC_PTR_DWCAS
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#elif !defined(__x86_64__) || !defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+#error "SYNC_PTR_DWCAS needs x86-64 and -mcx16."
+#endif
+#endif
+
+#ifndef __CC_SYNC_PTR_H__
+#include "cc/sync_ptr.h"
+#endif
+
+
+namespace cc
+{
+
+    /**
+    * \brief Pointer and generation read together, CAS expectation of tagged_atomic.
+    */
+    template<
+        class TPtr>
+    struct tagged_value
+    {
+        TPtr *      ptr_;
+        size_t      tag_;
+
+    }; // struct tagged_value
+
+
+    /**
+    * \class cc::tagged_atomic
+    *
+    * \brief Atomic pointer paired with a generation bumped by every store.
+    * CAS compares pointer and generation, so an expectation read before the pointer was replaced
+    * fails even if the same address got published again (ABA).
+    *
+    * With SYNC_PTR_DWCAS=1 pointer and generation are two words swapped with one 16 bytes CAS.
+    * Otherwise they are packed in one 64 bits word: 64 bits pointers keep their low 48 bits
+    * (user space addresses on x86-64 and AArch64) and a 16 bits generation,
+    * 32 bits pointers get a 32 bits generation. Packed generations wrap around.
+    */
+    template<
+        class TPtr>
+    class tagged_atomic final
+    {
+
+    public:
+        typedef tagged_value<TPtr> value_type;
+
+#if !SYNC_PTR_DWCAS
+        /** \brief Generation bits of the packed word. */
+        static constexpr unsigned tag_shift = sizeof(void *) == 8U ? 48U : 32U;
+        static constexpr std::uint64_t ptr_mask = (std::uint64_t(1U) << tag_shift) - 1U;
+#endif
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+#if SYNC_PTR_DWCAS
+        // Pointer then generation.
+        alignas(16) std::uint64_t       word_[2];
+#else
+        std::atomic<std::uint64_t>      word_;
+#endif
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        tagged_atomic(tagged_atomic const &) = delete;
+        void operator=(tagged_atomic const &) = delete;
+
+    public:
+        explicit tagged_atomic(
+            TPtr * p_ptr)
+            noexcept
+        {
+#if SYNC_PTR_DWCAS
+            word_[0] = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(p_ptr));
+            word_[1] = 0;
+#else
+            word_.store(pack(p_ptr, 0), std::memory_order_relaxed);
+#endif
+        }
+
+
+    public:
+        inline TPtr * load(
+            std::memory_order p_order = std::memory_order_seq_cst)
+            const noexcept
+        {
+#if SYNC_PTR_DWCAS
+            return to_ptr(load_word(0, p_order));
+#else
+            return unpack_ptr(word_.load(p_order));
+#endif
+        }
+
+        /**
+        * \brief Load pointer and generation as a CAS expectation.
+        * With SYNC_PTR_DWCAS=1 the two words are read separately, a torn read only fails the next CAS.
+        */
+        inline value_type load_tagged(
+            std::memory_order p_order = std::memory_order_seq_cst)
+            const noexcept
+        {
+#if SYNC_PTR_DWCAS
+            auto tag = load_word(1, p_order);
+            return value_type{ to_ptr(load_word(0, p_order)), static_cast<size_t>(tag) };
+#else
+            auto w = word_.load(p_order);
+            return value_type{ unpack_ptr(w), static_cast<size_t>(w >> tag_shift) };
+#endif
+        }
+
+        /**
+        * \brief Number of stores, a single load.
+        */
+        inline size_t generation(
+            std::memory_order p_order = std::memory_order_seq_cst)
+            const noexcept
+        {
+#if SYNC_PTR_DWCAS
+            return static_cast<size_t>(load_word(1, p_order));
+#else
+            return static_cast<size_t>(word_.load(p_order) >> tag_shift);
+#endif
+        }
+
+        /**
+        * \brief Store target pointer if pointer and generation still match the expectation.
+        * On failure the expectation is reloaded.
+        */
+        inline bool compare_exchange_strong(
+            value_type & p_expected,
+            TPtr * p_desired,
+            std::memory_order p_order = std::memory_order_seq_cst)
+            noexcept
+        {
+#if SYNC_PTR_DWCAS
+            (void)p_order;
+            if (cas_words(p_expected, p_desired))
+            {
+                return true;
+            }
+            p_expected = load_tagged(std::memory_order_acquire);
+            return false;
+#else
+            auto expected = pack(p_expected.ptr_, p_expected.tag_);
+            if (word_.compare_exchange_strong(
+                expected,
+                pack(p_desired, p_expected.tag_ + 1U),
+                p_order,
+                std::memory_order_acquire))
+            {
+                return true;
+            }
+            p_expected = value_type{ unpack_ptr(expected), static_cast<size_t>(expected >> tag_shift) };
+            return false;
+#endif
+        }
+
+        /**
+        * \brief Store target pointer, bump generation and return previous pointer.
+        */
+        inline TPtr * exchange(
+            TPtr * p_desired,
+            std::memory_order p_order = std::memory_order_seq_cst)
+            noexcept
+        {
+            auto expected = load_tagged(std::memory_order_relaxed);
+            while (!compare_exchange_strong(expected, p_desired, p_order))
+            {}
+            return expected.ptr_;
+        }
+
+
+    private:
+#if SYNC_PTR_DWCAS
+        static inline TPtr * to_ptr(
+            std::uint64_t p_word)
+            noexcept
+        {
+            return reinterpret_cast<TPtr *>(static_cast<std::uintptr_t>(p_word));
+        }
+
+        inline std::uint64_t load_word(
+            size_t p_index,
+            std::memory_order p_order)
+            const noexcept
+        {
+#if defined(_MSC_VER)
+            // x64 loads have acquire semantics, only compiler reordering is prevented.
+            (void)p_order;
+            auto w = static_cast<std::uint64_t>(
+                __iso_volatile_load64(reinterpret_cast<__int64 const volatile *>(&word_[p_index])));
+            _ReadWriteBarrier();
+            return w;
+#else
+            switch (p_order)
+            {
+            case std::memory_order_relaxed:
+                return __atomic_load_n(&word_[p_index], __ATOMIC_RELAXED);
+            case std::memory_order_seq_cst:
+                return __atomic_load_n(&word_[p_index], __ATOMIC_SEQ_CST);
+            default:
+                return __atomic_load_n(&word_[p_index], __ATOMIC_ACQUIRE);
+            }
+#endif
+        }
+
+        /**
+        * \brief Full barrier 16 bytes CAS, generation is bumped on success.
+        */
+        inline bool cas_words(
+            value_type const & p_expected,
+            TPtr * p_desired)
+            noexcept
+        {
+            auto ptr = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(p_expected.ptr_));
+            auto tag = static_cast<std::uint64_t>(p_expected.tag_);
+            auto desired = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(p_desired));
+#if defined(_MSC_VER)
+            __int64 comparand[2] = { static_cast<__int64>(ptr), static_cast<__int64>(tag) };
+            return _InterlockedCompareExchange128(
+                reinterpret_cast<__int64 volatile *>(word_),
+                static_cast<__int64>(tag + 1U),
+                static_cast<__int64>(desired),
+                comparand) != 0;
+#else
+            typedef unsigned __int128 dword_t;
+            return __sync_bool_compare_and_swap(
+                reinterpret_cast<dword_t *>(word_),
+                (static_cast<dword_t>(tag) << 64U) | ptr,
+                (static_cast<dword_t>(tag + 1U) << 64U) | desired);
+#endif
+        }
+#else
+        static inline std::uint64_t pack(
+            TPtr * p_ptr,
+            size_t p_tag)
+            noexcept
+        {
+            auto ptr = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(p_ptr));
+            assert((ptr & ~ptr_mask) == 0 && "Pointer doesn't fit the packed tagged word.");
+            return (static_cast<std::uint64_t>(p_tag) << tag_shift) | ptr;
+        }
+
+        static inline TPtr * unpack_ptr(
+            std::uint64_t p_word)
+            noexcept
+        {
+            return reinterpret_cast<TPtr *>(static_cast<std::uintptr_t>(p_word & ptr_mask));
+        }
+#endif
+
+    }; // class tagged_atomic
+
+
+    /**
+    * \brief Compact body layout with a tagged pointer.
+    * CAS based reset(), release() and exchange() can't succeed on a stale expectation
+    * and generation() is read from the pointer word.
+    */
+    template<
+        class TPtr>
+    struct tagged_body_layout
+    {
+        std::atomic<size_t>	        ref_count_;
+        std::atomic<size_t>	        ref_count_ptr_;
+        tagged_atomic<TPtr>		    ptr_;
+
+        tagged_body_layout(
+            size_t p_ref_count,
+            size_t p_ref_count_ptr,
+            TPtr * p_ptr)
+            noexcept
+            : ref_count_(p_ref_count)
+            , ref_count_ptr_(p_ref_count_ptr)
+            , ptr_(p_ptr)
+        {}
+
+    }; // struct tagged_body_layout
+
+    template<
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter>
+    using tagged_sync_ptr = sync_ptr<TPtr, TDeleter, tagged_body_layout>;
+
+} // namespace cc
+
+#endif // __CC_SYNC_PTR_TAGGED_H__
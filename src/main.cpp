@@ -1,6 +1,24 @@
 
 #include "tests/cc_sync_ptr.h"
+#include "tests/cc_sync_ptr_contention.h"
+#include "tests/cc_sync_ptr_group.h"
+#include "tests/cc_sync_ptr_hazard.h"
+#include "tests/cc_sync_ptr_tagged.h"
 #include "tests/mem_sync_ptr.h"
+#include "tests/mem_sync_ptr_async.h"
+#include "tests/mem_sync_ptr_biased.h"
+#include "tests/mem_sync_ptr_bravo.h"
+#include "tests/mem_sync_ptr_cached.h"
+#include "tests/mem_sync_ptr_epoch.h"
+#include "tests/mem_sync_ptr_group.h"
+#include "tests/mem_sync_ptr_intrusive.h"
+#include "tests/mem_sync_ptr_numa.h"
+#include "tests/mem_sync_ptr_pool.h"
+#include "tests/mem_sync_ptr_rcu.h"
+#include "tests/mem_sync_ptr_reclaim.h"
+#include "tests/mem_sync_ptr_sharded.h"
+#include "tests/mem_sync_ptr_table.h"
+#include "tests/mem_sync_ptr_wait.h"
 
 
 int main(
@@ -11,11 +29,78 @@ int main(
     tests::cc_sync_ptr_release();
     tests::cc_sync_ptr_exchange();
     tests::cc_sync_ptr_allocator();
+    tests::cc_sync_ptr_inplace();
+    tests::cc_sync_ptr_layout();
+    tests::cc_sync_ptr_ref();
+    tests::cc_sync_ptr_allocate();
+    tests::cc_sync_ptr_empty();
+    tests::cc_sync_ptr_weak();
+    tests::cc_sync_ptr_array();
+
+    tests::cc_sync_ptr_contention_policy();
+    tests::cc_sync_ptr_contention_writers();
+
+    tests::cc_sync_ptr_group_commit();
+
+    tests::cc_sync_ptr_hazard_protect();
+    tests::cc_sync_ptr_hazard_concurrent();
+
+    tests::cc_sync_ptr_tagged_aba();
+    tests::cc_sync_ptr_tagged_concurrent();
 
     tests::mem_sync_ptr_synchro();
     tests::mem_sync_ptr_release();
     tests::mem_sync_ptr_exchange();
     tests::mem_sync_ptr_allocator();
+    tests::mem_sync_ptr_inplace();
+    tests::mem_sync_ptr_ref_counter();
+    tests::mem_sync_ptr_packed_counter();
+    tests::mem_sync_ptr_ref();
+    tests::mem_sync_ptr_allocate();
+    tests::mem_sync_ptr_empty();
+    tests::mem_sync_ptr_weak();
+    tests::mem_sync_ptr_array();
+
+    tests::mem_sync_ptr_biased_owner();
+    tests::mem_sync_ptr_biased_handoff();
+    tests::mem_sync_ptr_biased_merge_race();
+    tests::mem_sync_ptr_biased_records();
+
+    tests::mem_sync_ptr_bravo_synchro();
+    tests::mem_sync_ptr_bravo_inhibit();
+
+    tests::mem_sync_ptr_cached_version();
+    tests::mem_sync_ptr_cached_reader();
+
+    tests::mem_sync_ptr_epoch_deleter();
+    tests::mem_sync_ptr_epoch_concurrent();
+
+    tests::mem_sync_ptr_group_commit();
+
+    tests::mem_sync_ptr_pool_reuse();
+    tests::mem_sync_ptr_pool_threads();
+    tests::mem_sync_ptr_pool_thread_exit();
+
+    tests::mem_sync_ptr_rcu_grace();
+    tests::mem_sync_ptr_rcu_deferred();
+    tests::mem_sync_ptr_rcu_in_section();
+
+    tests::mem_sync_ptr_sharded_release();
+
+    tests::mem_sync_ptr_wait_change();
+
+    tests::mem_sync_ptr_reset_async();
+
+    tests::mem_sync_ptr_reclaim_background();
+
+    tests::mem_sync_ptr_numa_topology();
+    tests::mem_sync_ptr_numa_replicas();
+
+    tests::mem_sync_ptr_intrusive_chain();
+    tests::mem_sync_ptr_intrusive_hook();
+
+    tests::mem_sync_ptr_table_handles();
+    tests::mem_sync_ptr_table_threads();
 
     return 0;
 }
@@ -3,11 +3,24 @@
 #define __MEMORY_SYNC_PTR_H__
 
 #include <cassert>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
 
 #ifndef __MEMORY_SYNC_PTR_POLICY_H__
 #include "mem/sync_ptr_policy.h"
 #endif
 
+#ifndef __MEMORY_SYNC_PTR_POOL_H__
+#include "mem/sync_ptr_pool.h"
+#endif
+
+#ifndef __MEMORY_SYNC_PTR_VERSION_H__
+#include "mem/sync_ptr_version.h"
+#endif
+
 
 namespace mem
 {
@@ -24,6 +37,23 @@ namespace mem
     using sync_ptr_ref_counter			= atomic_ref_counter;
 
 
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class THolder = sync_ptr_holder,
+        class TRefCounter = sync_ptr_ref_counter>
+    class sync_ref;
+
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class THolder = sync_ptr_holder,
+        class TRefCounter = sync_ptr_ref_counter>
+    class sync_weak_ptr;
+
+    class sync_group;
+
+
     /** 
     * \class mem::sync_ptr
     *
@@ -31,6 +61,10 @@ namespace mem
     * Used to avoid cross module cycle.
     * When the original sync_ptr or one of its copy underlying raw pointer changes, 
     * all sync_ptr and copies point to the updated raw pointer.
+    *
+    * Default constructed and moved-from sync_ptr hold no body and allocate nothing.
+    * They are not part of any chain, copies of them are independent empty sync_ptr,
+    * and the first reset() or exchange() gives them a chain of their own.
     */
     template <
         class TPtr,
@@ -42,6 +76,7 @@ namespace mem
 
     public:
         typedef typename TPtr		    pointer_type;
+        typedef typename std::remove_extent<TPtr>::type element_type;
         typedef typename TDeleter<TPtr>	deleter_type;
         typedef typename THolder<TPtr>	holder_type;
         typedef typename TRefCounter	reference_counter_type;
@@ -65,6 +100,30 @@ namespace mem
             , private TRefCounter
         {
 
+            //////////////////////////////////////
+            //              MEMBERS             //
+            //////////////////////////////////////
+
+        private:
+            typedef void (*dispose_t)(body *);
+            typedef void (*destroy_t)(body *, TPtr *);
+
+            /**
+            * \brief Storage of the chain: how the body is freed and a pointee living in its block destroyed.
+            */
+            struct storage
+            {
+                dispose_t       dispose_;
+                destroy_t       destroy_;
+                bool            detachable_;
+            };
+
+        private:
+            storage const *         storage_;
+            TPtr *                  inplace_;
+            version_word            version_;
+
+
             //////////////////////////////////////
             //              METHODS             //
             //////////////////////////////////////
@@ -76,14 +135,6 @@ namespace mem
             void operator=(body && p_arg) = delete;
 
         public:
-            /** 
-            * \brief Construct default empty object. 
-            */
-            body(
-                void)
-                noexcept
-            {}
-            
             /** 
             * \brief Construct with compatible pointer. 
             */
@@ -94,8 +145,13 @@ namespace mem
                 noexcept 
                 // Inheritance.
                 : THolder<TPtr>(p_ptr)
+                // Members.
+                , storage_(&storage_of<&dispose_delete, nullptr, true>::value)
+                , inplace_(nullptr)
+                , version_()
             {
                 assert(p_ptr);
+                bind_counter(static_cast<TRefCounter &>(*this), 0);
                 increment_ptr();
             }
 
@@ -106,15 +162,389 @@ namespace mem
             {}
 
 
+        public:
+            /**
+            * \brief Create body and pointee in a single allocation.
+            * The pointee is constructed in a slot trailing the body.
+            */
+            template<
+                class... TArgs>
+            static body * create_inplace(
+                TArgs&&... p_args)
+            {
+                static_assert(
+                    alignof(TPtr) <= alignof(std::max_align_t),
+                    "Over-aligned types can't be constructed in place.");
+                static_assert(
+                    is_immediate_deleter<TDeleter<TPtr>>::value,
+                    "In place pointees need a deleter freeing synchronously, the slot can't be retired.");
+                static_assert(
+                    std::is_move_constructible<TPtr>::value,
+                    "In place pointees must be movable to leave the chain through release() or exchange().");
+
+                void * mem = ::operator new(inplace_offset() + sizeof(TPtr));
+                TPtr * ptr = nullptr;
+                try
+                {
+                    ptr = ::new (static_cast<char *>(mem) + inplace_offset()) TPtr(
+                        std::forward<TArgs>(p_args)...);
+                }
+                catch (...)
+                {
+                    ::operator delete(mem);
+                    throw;
+                }
+
+                body * b = ::new (mem) body(ptr);
+                b->storage_ = &storage_of<&dispose_inplace, &destroy_inplace_slot, true>::value;
+                b->inplace_ = ptr;
+                return b;
+            }
+
+
+            /**
+            * \brief Create body and pointee in a single block obtained from target allocator.
+            * The pointee is constructed through the allocator, so uses-allocator types
+            * (std::pmr containers) get the same memory resource.
+            * A copy of the allocator, rebound to max_align_t, is kept in the block to free it.
+            */
+            template<
+                class TAlloc,
+                class... TArgs>
+            static body * create_allocated(
+                TAlloc const & p_alloc,
+                TArgs&&... p_args)
+            {
+                typedef typename std::allocator_traits<TAlloc>::template rebind_alloc<std::max_align_t> unit_alloc_t;
+                typedef typename std::allocator_traits<TAlloc>::template rebind_alloc<TPtr> ptr_alloc_t;
+                typedef std::allocator_traits<unit_alloc_t> unit_traits_t;
+
+                static_assert(
+                    alignof(TPtr) <= alignof(std::max_align_t) && alignof(unit_alloc_t) <= alignof(std::max_align_t),
+                    "Over-aligned types can't be constructed in place.");
+                static_assert(
+                    std::is_pointer<typename unit_traits_t::pointer>::value,
+                    "Allocators with fancy pointers aren't supported.");
+                static_assert(
+                    is_immediate_deleter<TDeleter<TPtr>>::value,
+                    "In place pointees need a deleter freeing synchronously, the slot can't be retired.");
+                static_assert(
+                    std::is_move_constructible<TPtr>::value,
+                    "In place pointees must be movable to leave the chain through release() or exchange().");
+
+                unit_alloc_t alloc(p_alloc);
+                auto * mem = reinterpret_cast<char *>(
+                    unit_traits_t::allocate(alloc, allocated_units<unit_alloc_t>()));
+                auto * ptr = reinterpret_cast<TPtr *>(mem + allocated_ptr_offset<unit_alloc_t>());
+                try
+                {
+                    ptr_alloc_t ptr_alloc(alloc);
+                    std::allocator_traits<ptr_alloc_t>::construct(
+                        ptr_alloc,
+                        ptr,
+                        std::forward<TArgs>(p_args)...);
+                }
+                catch (...)
+                {
+                    unit_traits_t::deallocate(
+                        alloc,
+                        reinterpret_cast<std::max_align_t *>(mem),
+                        allocated_units<unit_alloc_t>());
+                    throw;
+                }
+
+                ::new (mem + allocated_alloc_offset<unit_alloc_t>()) unit_alloc_t(std::move(alloc));
+                body * b = ::new (mem) body(ptr);
+                b->storage_ = &storage_of<&dispose_allocated<unit_alloc_t>, &destroy_allocated<unit_alloc_t>, false>::value;
+                b->inplace_ = ptr;
+                return b;
+            }
+
+
+#if defined(SYNC_PTR_BODY_POOL)
+            /**
+            * \brief Allocate bodies from the slab pool of their type.
+            */
+            static void * operator new(
+                size_t p_size)
+            {
+                assert(p_size == sizeof(body));
+                return body_pool<body>::instance().allocate();
+            }
+
+            static void operator delete(
+                void * p_ptr)
+                noexcept
+            {
+                body_pool<body>::instance().deallocate(p_ptr);
+            }
+#endif // SYNC_PTR_BODY_POOL
+
+
+        private:
+            static constexpr size_t inplace_offset(
+                void)
+                noexcept
+            {
+                return (sizeof(body) + alignof(TPtr) - 1U) & ~(alignof(TPtr) - 1U);
+            }
+
+            static void dispose_delete(
+                body * p_body)
+            {
+                delete p_body;
+            }
+
+            static void dispose_inplace(
+                body * p_body)
+            {
+                p_body->~body();
+                ::operator delete(p_body);
+            }
+
+            static constexpr size_t align_up(
+                size_t p_size,
+                size_t p_align)
+                noexcept
+            {
+                return (p_size + p_align - 1U) & ~(p_align - 1U);
+            }
+
+            template<
+                class TUnitAlloc>
+            static constexpr size_t allocated_alloc_offset(
+                void)
+                noexcept
+            {
+                return align_up(sizeof(body), alignof(TUnitAlloc));
+            }
+
+            template<
+                class TUnitAlloc>
+            static constexpr size_t allocated_ptr_offset(
+                void)
+                noexcept
+            {
+                return align_up(allocated_alloc_offset<TUnitAlloc>() + sizeof(TUnitAlloc), alignof(TPtr));
+            }
+
+            template<
+                class TUnitAlloc>
+            static constexpr size_t allocated_units(
+                void)
+                noexcept
+            {
+                return align_up(allocated_ptr_offset<TUnitAlloc>() + sizeof(TPtr), sizeof(std::max_align_t)) /
+                    sizeof(std::max_align_t);
+            }
+
+            template<
+                class TUnitAlloc>
+            static void dispose_allocated(
+                body * p_body)
+            {
+                auto * mem = reinterpret_cast<char *>(p_body);
+                auto * slot = reinterpret_cast<TUnitAlloc *>(mem + allocated_alloc_offset<TUnitAlloc>());
+                TUnitAlloc alloc(std::move(*slot));
+                slot->~TUnitAlloc();
+                p_body->~body();
+                std::allocator_traits<TUnitAlloc>::deallocate(
+                    alloc,
+                    reinterpret_cast<std::max_align_t *>(mem),
+                    allocated_units<TUnitAlloc>());
+            }
+
+            template<
+                class TUnitAlloc>
+            static void destroy_allocated(
+                body * p_body,
+                TPtr * p_ptr)
+            {
+                typedef typename std::allocator_traits<TUnitAlloc>::template rebind_alloc<TPtr> ptr_alloc_t;
+
+                auto * slot = reinterpret_cast<TUnitAlloc *>(
+                    reinterpret_cast<char *>(p_body) + allocated_alloc_offset<TUnitAlloc>());
+                ptr_alloc_t alloc(*slot);
+                std::allocator_traits<ptr_alloc_t>::destroy(alloc, p_ptr);
+            }
+
+            static void destroy_inplace_slot(
+                body *,
+                TPtr * p_ptr)
+            {
+                destroy_inplace(p_ptr);
+            }
+
+            template<
+                dispose_t TDispose,
+                destroy_t TDestroy,
+                bool TDetachable>
+            struct storage_of
+            {
+                static constexpr storage value = { TDispose, TDestroy, TDetachable };
+            };
+
+
+        private:
+            /**
+            * \brief Release reported by the counter policy outside of unref() or unref_ptr().
+            */
+            static void counter_released(
+                TRefCounter * p_counter,
+                bool p_ptr)
+            {
+                auto * b = static_cast<body *>(p_counter);
+                if (p_ptr)
+                {
+                    b->release_ptr(nullptr);
+                }
+                else
+                {
+                    b->release_this();
+                }
+            }
+
+            /**
+            * \brief Hook counter policies reporting releases outside of decrement (see biased_ref_counter).
+            */
+            template<
+                class TCounter>
+            static auto bind_counter(
+                TCounter & p_counter,
+                int)
+                noexcept
+                -> decltype(p_counter.bind(&counter_released), void())
+            {
+                p_counter.bind(&counter_released);
+            }
+
+            template<
+                class TCounter>
+            static void bind_counter(
+                TCounter &,
+                long)
+                noexcept
+            {}
+
+            /**
+            * \brief Hand a replaced pointer to holder policies which can't wait for readers
+            * of the calling thread (see ptr_holder_rcu), return true if they took it.
+            */
+            template<
+                class THolderPolicy>
+            static auto defer_ptr(
+                THolderPolicy & p_holder,
+                body * p_body,
+                TPtr * p_ptr,
+                int)
+                noexcept
+                -> decltype(p_holder.defer(nullptr, nullptr), bool())
+            {
+                if (!p_holder.deferring())
+                {
+                    return false;
+                }
+                if (p_ptr == p_body->inplace_)
+                {
+                    // The in-place slot keeps its block until destroyed.
+                    p_body->ref();
+                    p_holder.defer(p_body, &dispose_deferred_inplace);
+                }
+                else
+                {
+                    p_holder.defer(p_ptr, &dispose_deferred);
+                }
+                return true;
+            }
+
+            template<
+                class THolderPolicy>
+            static bool defer_ptr(
+                THolderPolicy &,
+                body *,
+                TPtr *,
+                long)
+                noexcept
+            {
+                return false;
+            }
+
+            static void dispose_deferred(
+                void * p_ptr)
+            {
+                TDeleter<TPtr>().free(static_cast<TPtr *>(p_ptr));
+            }
+
+            static void dispose_deferred_inplace(
+                void * p_body)
+            {
+                auto * b = static_cast<body *>(p_body);
+                b->storage_->destroy_(b, b->inplace_);
+                b->unref();
+            }
+
+            /**
+            * \brief Count a sync_ptr with one RMW when the counter policy packs both counts (see packed_ref_counter).
+            */
+            template<
+                class TCounter>
+            static auto increment_both(
+                TCounter & p_counter,
+                int)
+                noexcept
+                -> decltype(p_counter.increment_both(), void())
+            {
+                p_counter.increment_both();
+            }
+
+            template<
+                class TCounter>
+            static void increment_both(
+                TCounter & p_counter,
+                long)
+                noexcept
+            {
+                p_counter.increment();
+                p_counter.increment_ptr();
+            }
+
+            template<
+                class TCounter>
+            static auto decrement_both(
+                TCounter & p_counter,
+                ref_counts & p_previous,
+                int)
+                noexcept
+                -> decltype(p_counter.decrement_both(p_previous))
+            {
+                return p_counter.decrement_both(p_previous);
+            }
+
+            template<
+                class TCounter>
+            static bool decrement_both(
+                TCounter &,
+                ref_counts &,
+                long)
+                noexcept
+            {
+                return false;
+            }
+
+
         private:
             inline void release_this(
                 void) 
                 noexcept
             {
-                delete this;
+                storage_->dispose_(this);
             }
 
-            inline void release_ptr(
+            /**
+            * \brief Free pointer previously held by this.
+            * The in-place slot is destroyed, separately allocated pointers go to the deleter.
+            */
+            inline void dispose_ptr(
                 TPtr * p_ptr)
                 noexcept
             {
@@ -122,14 +552,130 @@ namespace mem
                     noexcept(free(p_ptr)),
                     "Deleter policy must offer no-throw guarantee.");
 
+                if (defer_ptr(static_cast<THolder<TPtr> &>(*this), this, p_ptr, 0))
+                {
+                    return;
+                }
+                if (p_ptr == inplace_)
+                {
+                    storage_->destroy_(this, p_ptr);
+                }
+                else
+                {
+                    free(p_ptr);
+                }
+            }
+
+            /**
+            * \brief Throw std::logic_error while the pointee built with an allocator is current,
+            * it lives in the allocator block and can't leave the chain.
+            * Once replaced the slot never comes back, so the check can't race with reset().
+            */
+            inline void check_detachable(
+                void)
+                const
+            {
+                if (!storage_->detachable_ && get_ptr() == inplace_)
+                {
+                    throw std::logic_error("Pointees built with an allocator can't leave their chain.");
+                }
+            }
+
+            /**
+            * \brief Hand out pointer previously held by this.
+            * The in-place slot is moved to its own allocation so ownership can leave the chain,
+            * if that throws the in-place pointee is destroyed and the exception propagates.
+            */
+            inline TPtr * detach_ptr(
+                TPtr * p_ptr)
+            {
+                if (p_ptr && p_ptr == inplace_)
+                {
+                    return relocate(
+                        p_ptr, 
+                        std::is_move_constructible<TPtr>());
+                }
+                return p_ptr;
+            }
+
+            static TPtr * relocate(
+                TPtr * p_ptr,
+                std::true_type)
+            {
+                TPtr * ptr = nullptr;
+                try
+                {
+                    ptr = new TPtr(std::move(*p_ptr));
+                }
+                catch (...)
+                {
+                    destroy_inplace(p_ptr);
+                    throw;
+                }
+                destroy_inplace(p_ptr);
+                return ptr;
+            }
+
+            /**
+            * \brief Never reached, in place construction requires movable pointees.
+            */
+            static TPtr * relocate(
+                TPtr * p_ptr,
+                std::false_type)
+                noexcept
+            {
+                assert(!"In-place pointee isn't movable and can't leave the chain.");
+                return p_ptr;
+            }
+
+            /**
+            * \brief Destroy the in-place slot, arrays never live in it.
+            */
+            static inline void destroy_inplace(
+                TPtr * p_ptr)
+                noexcept
+            {
+                destroy_inplace(p_ptr, std::is_array<TPtr>());
+            }
+
+            static inline void destroy_inplace(
+                TPtr * p_ptr,
+                std::false_type)
+                noexcept
+            {
+                p_ptr->~TPtr();
+            }
+
+            static inline void destroy_inplace(
+                TPtr *,
+                std::true_type)
+                noexcept
+            {}
+
+            /**
+            * \brief Set pointer through the holder and bump version, return previous pointer.
+            */
+            inline TPtr * store_ptr(
+                TPtr * p_ptr)
+                noexcept
+            {
+                auto p = set(p_ptr);
+                version_.bump();
+                return p;
+            }
+
+            inline void release_ptr(
+                TPtr * p_ptr)
+                noexcept
+            {
                 static_assert(
                     noexcept(set(p_ptr)),
                     "Pointer holder policy must offer no-throw guarantee.");
 
-                auto p = set(p_ptr);                    
+                auto p = store_ptr(p_ptr);
                 if (p)
                 {
-                    free(p);
+                    dispose_ptr(p);
                 }
             }
 
@@ -202,9 +748,69 @@ namespace mem
                     }
                 }
             }
-
-
-        public:
+            /** 
+            * \brief Increments pointer reference count unless the pointer was already released.
+            * Return true on success, see sync_weak_ptr::lock().
+            * Like ref_ptr(), an empty chain isn't counted, unref_ptr() won't count it down.
+            */
+            inline bool try_ref_ptr(
+                void) 
+                noexcept
+            {
+                static_assert(
+                    noexcept(try_increment_ptr()),
+                    "Reference counter policy must offer no-throw guarantee.");
+
+                if (!get_ptr())
+                {
+                    return get_ref_count_ptr() > 0;
+                }
+                return try_increment_ptr();
+            }
+            /** 
+            * \brief Increments both reference counts, a sync_ptr joining the chain.
+            * Counter policies offering increment_both() do it with one RMW.
+            */
+            inline void ref_both(
+                void) 
+                noexcept
+            {
+                if (get_ptr())
+                {
+                    increment_both(static_cast<TRefCounter &>(*this), 0);
+                }
+                else
+                {
+                    ref();
+                }
+            }
+            /** 
+            * \brief Decrements both reference counts, a sync_ptr leaving the chain.
+            * Counter policies offering decrement_both() do it with one RMW.
+            */
+            inline void unref_both(
+                void) 
+                noexcept
+            {
+                ref_counts previous;
+                if (get_ptr() && decrement_both(static_cast<TRefCounter &>(*this), previous, 0))
+                {
+                    if (previous.count_ptr_ == 1U)
+                    {
+                        release_ptr(nullptr);
+                    }
+                    if (previous.count_ == 1U)
+                    {
+                        release_this();
+                    }
+                    return;
+                }
+                unref_ptr();
+                unref();
+            }
+
+
+        public:
             template<
                 class TPtrCompatible>
             inline void reset_ptr(
@@ -227,20 +833,19 @@ namespace mem
         public:
             inline TPtr * release(
                 void)
-                noexcept
             {
                 static_assert(
                     noexcept(set(nullptr)),
                     "Pointer holder policy must offer no-throw guarantee.");
 
-                return set(nullptr);
+                check_detachable();
+                return detach_ptr(store_ptr(nullptr));
             }
 
             template<
                 class TPtrCompatible>
             inline TPtr * exchange(
                 TPtrCompatible * p_ptr)
-                noexcept
             {
                 static_assert(
                     noexcept(set(p_ptr)),
@@ -248,7 +853,54 @@ namespace mem
 
                 assert(p_ptr);
                 assert(p_ptr != get_ptr());
-                return set(p_ptr);
+                check_detachable();
+                return detach_ptr(store_ptr(p_ptr));
+            }
+
+
+            ///////////////////////////////////////////////////////////////////////////////////////
+            //		GROUP (see sync_group)
+            ///////////////////////////////////////////////////////////////////////////////////////
+
+        public:
+            /**
+            * \brief Lock pointer holder, the locking thread keeps using set() and get().
+            */
+            inline void lock_ptr(
+                void)
+                const noexcept
+            {
+                lock();
+            }
+
+            inline void unlock_ptr(
+                void)
+                const noexcept
+            {
+                unlock();
+            }
+
+            /**
+            * \brief Set pointer and return previous one, which is left to retire_ptr().
+            */
+            inline TPtr * swap_ptr(
+                TPtr * p_ptr)
+                noexcept
+            {
+                return store_ptr(p_ptr);
+            }
+
+            /**
+            * \brief Free pointer swapped out of, or never published to, this.
+            */
+            inline void retire_ptr(
+                TPtr * p_ptr)
+                noexcept
+            {
+                if (p_ptr)
+                {
+                    dispose_ptr(p_ptr);
+                }
             }
 
 
@@ -290,6 +942,33 @@ namespace mem
                 return get();
             }
 
+            /**
+            * \brief Number of pointer changes, bumped after each one.
+            */
+            inline size_t get_version(
+                std::memory_order p_order)
+                const noexcept
+            {
+                return version_.load(p_order);
+            }
+
+            inline version_word const & get_version_word(
+                void)
+                const noexcept
+            {
+                return version_;
+            }
+
+            /**
+            * \brief Bump version without pointer change, see sync_ptr::notify().
+            */
+            inline void notify_version(
+                void)
+                noexcept
+            {
+                version_.bump();
+            }
+
         }; // class body
 
 
@@ -313,20 +992,50 @@ namespace mem
     private:
         body_t *		body_;
 
+        friend class sync_ref<
+            TPtr,
+            TDeleter,
+            THolder,
+            TRefCounter>;
+
+        friend class sync_weak_ptr<
+            TPtr,
+            TDeleter,
+            THolder,
+            TRefCounter>;
+
+        friend class sync_group;
+
+        friend struct version_access;
+
 
         //////////////////////////////////////
         //              METHODS             //
         //////////////////////////////////////
 
+    private:
+        /**
+        * \brief Construct sharing target body, see sync_ref::sync().
+        */
+        explicit sync_ptr(
+            body_t * p_body)
+            noexcept
+            // Members.
+            : body_(p_body)
+        {
+            link(body_);
+        }
+
     public:
         /**
         * \brief Construct default empty object.
+        * No body is allocated until a pointer is set.
         */
-        sync_ptr(
+        constexpr sync_ptr(
             void)
             noexcept
             // Members.
-            : body_(new body_t())
+            : body_(nullptr)
         {}
 
         /**
@@ -336,9 +1045,37 @@ namespace mem
             class TPtrCompatible>
         sync_ptr(
             TPtrCompatible * p_ptr)
-            noexcept
             // Members.
-            : body_(new body_t(p_ptr))
+            : body_(create_body(p_ptr))
+        {}
+
+        /**
+        * \brief Construct pointee in place.
+        * Body and pointee share a single allocation.
+        */
+        template<
+            class... TArgs>
+        explicit sync_ptr(
+            inplace_t,
+            TArgs&&... p_args)
+            // Members.
+            : body_(body_t::create_inplace(std::forward<TArgs>(p_args)...))
+        {}
+
+        /**
+        * \brief Construct pointee with target allocator.
+        * Body and pointee share a single block obtained from the allocator, which also destroys the pointee.
+        * The pointee can't leave the chain, release() and exchange() throw std::logic_error while it is current.
+        */
+        template<
+            class TAlloc,
+            class... TArgs>
+        explicit sync_ptr(
+            std::allocator_arg_t,
+            TAlloc const & p_alloc,
+            TArgs&&... p_args)
+            // Members.
+            : body_(body_t::create_allocated(p_alloc, std::forward<TArgs>(p_args)...))
         {}
 
         sync_ptr(
@@ -356,30 +1093,26 @@ namespace mem
             // Members.
             : body_(p_other.body_)
         {
-            body_->ref();
-            body_->ref_ptr();
+            link(body_);
         }
 
         ~sync_ptr(
             void) 
             noexcept
         {
-            if (body_)
-            {
-                body_->unref_ptr();
-                body_->unref();
-            }
+            unlink(body_);
         }
 
         inline sync_ptr_t & operator=(
             sync_ptr_t && p_other)
             noexcept
         {
-            auto * tmp = p_other.body_;
-            if (tmp != body_)
+            if (&p_other != this)
             {
-                body_ = tmp;
+                auto * tmp = body_;
+                body_ = p_other.body_;
                 p_other.body_ = nullptr;
+                unlink(tmp);
             }
             return *this;
         }
@@ -391,12 +1124,10 @@ namespace mem
             auto * tmp = p_other.body_;
             if (tmp != body_)
             {
-                body_->unref_ptr();
-                body_->unref();
+                unlink(body_);
 
                 body_ = tmp;
-                body_->ref();
-                body_->ref_ptr();
+                link(body_);
             }
             return *this;
         }
@@ -411,13 +1142,93 @@ namespace mem
         }
 
 
+    private:
+        /**
+        * \brief Create a body owning target pointer, free the pointer if the body can't be allocated.
+        */
+        template<
+            class TPtrCompatible>
+        static body_t * create_body(
+            TPtrCompatible * p_ptr)
+        {
+            try
+            {
+                return new body_t(p_ptr);
+            }
+            catch (...)
+            {
+                if (p_ptr)
+                {
+                    TDeleter<TPtr>().free(p_ptr);
+                }
+                throw;
+            }
+        }
+
+        static void link(
+            body_t * p_body)
+            noexcept
+        {
+            if (p_body)
+            {
+                p_body->ref_both();
+            }
+        }
+
+        static void unlink(
+            body_t * p_body)
+            noexcept
+        {
+            if (p_body)
+            {
+                p_body->unref_both();
+            }
+        }
+
+
     public:
         inline size_t count(
             void)
             const noexcept
         {
-            return body_->get_ref_count_ptr();
+            return body_ ? body_->get_ref_count_ptr() : 0;
+        }
+
+        /**
+        * \brief Chain version, bumped after every pointer change (reset, release, exchange).
+        * Empty sync_ptr report 0, see cached_reader.
+        */
+        inline size_t version(
+            std::memory_order p_order = std::memory_order_acquire)
+            const noexcept
+        {
+            return body_ ? body_->get_version(p_order) : 0;
+        }
+
+        /**
+        * \brief Bump chain version and wake waiters without changing the pointer,
+        * used to signal in place pointee updates. See mem::wait_for_change().
+        */
+        inline void notify(
+            void)
+            noexcept
+        {
+            if (body_)
+            {
+                body_->notify_version();
+            }
+        }
+
+#if defined(SYNC_PTR_BODY_POOL)
+        /**
+        * \brief Body pool statistics of this sync_ptr type.
+        */
+        static pool_stats body_pool_stats(
+            void)
+        {
+            return body_pool<body_t>::instance().stats();
         }
+#endif // SYNC_PTR_BODY_POOL
 
 
     public:
@@ -429,10 +1240,16 @@ namespace mem
             class TPtrCompatible>
         inline void reset(
             TPtrCompatible * p_ptr)
-            noexcept
         {
             assert(p_ptr);
-            body_->reset_ptr(p_ptr);
+            if (body_)
+            {
+                body_->reset_ptr(p_ptr);
+            }
+            else
+            {
+                body_ = create_body(p_ptr);
+            }
         }
         /**
         * \brief Set underlying pointer to null.
@@ -442,10 +1259,12 @@ namespace mem
             void)
             noexcept
         {
-            body_->reset_ptr();
+            if (body_)
+            {
+                body_->reset_ptr();
+            }
         }
 
-
     public:
         /**
         * \brief Releases the ownership of the managed object if any.
@@ -453,9 +1272,8 @@ namespace mem
         */
         inline TPtr * release(
             void)
-            noexcept
         {
-            return body_->release();
+            return body_ ? body_->release() : nullptr;
         }
         /**
         * \brief Set managed object and return previous one.
@@ -464,8 +1282,15 @@ namespace mem
             class TPtrCompatible>
         inline TPtr * exchange(
             TPtrCompatible * p_ptr)
-            noexcept
         {
+            if (!body_)
+            {
+                if (p_ptr)
+                {
+                    body_ = create_body(p_ptr);
+                }
+                return nullptr;
+            }
             return body_->exchange(p_ptr);
         }
 
@@ -475,7 +1300,7 @@ namespace mem
             void) 
             const noexcept
         {
-            return body_->get_ptr();
+            return body_ ? body_->get_ptr() : nullptr;
         }
 
         inline TPtr & operator*(
@@ -492,6 +1317,34 @@ namespace mem
             return get();
         }
 
+        /**
+        * \brief Element of an array pointee.
+        */
+        inline element_type & operator[](
+            size_t p_index)
+            const noexcept
+        {
+            static_assert(
+                std::is_array<TPtr>::value,
+                "operator[] needs an array pointee.");
+            return (*get())[p_index];
+        }
+
+        /**
+        * \brief Element count of an array pointee, 0 when empty.
+        * Two calls may see two arrays while the chain is reset,
+        * size a pointer read once from get() with array_block::size() instead.
+        */
+        inline size_t size(
+            void)
+            const noexcept
+        {
+            static_assert(
+                std::is_array<TPtr>::value,
+                "size() needs an array pointee.");
+            return array_block<element_type>::size(get());
+        }
+
 
     public:
         inline bool valid(
@@ -511,54 +1364,435 @@ namespace mem
     }; // class sync_ptr
 
 
-    ///////////////////////////////////////////////////////////////////////////////////////////
-    //		MAKE
-    ///////////////////////////////////////////////////////////////////////////////////////////
-
+    /**
+    * \class mem::sync_ref
+    *
+    * \brief Borrowed view of a sync_ptr chain.
+    * Reads through the chain body without touching reference counts, 
+    * meant to be passed by value to short-lived calls instead of a sync_ptr.
+    * The view stays valid as long as one sync_ptr of the chain outlives it,
+    * sync() returns a full sync_ptr when the reference has to escape.
+    */
     template <
         class TPtr,
-        template <class T> class TDeleter = sync_ptr_deleter,
-        template <class T> class THolder = sync_ptr_holder,
-        class TRefCounter = sync_ptr_ref_counter,
-        class... TArgs>
-    inline typename std::enable_if<
-        !std::is_array<TPtr>::value, 
-        mem::sync_ptr<TPtr, TDeleter, THolder, TRefCounter>>::type
-        make_sync(
-            TArgs&&... p_args)
+        template <class T> class TDeleter,
+        template <class T> class THolder,
+        class TRefCounter>
+    class sync_ref final
     {
+
+    public:
+        typedef typename TPtr           pointer_type;
         typedef typename sync_ptr<
             TPtr,
             TDeleter,
             THolder,
-            TRefCounter> sync_ptr_t;
-        return (sync_ptr_t(new TPtr(std::forward<TArgs>(p_args)...)));
-    }
+            TRefCounter>   sync_ptr_type;
 
-    template<
-        class TPtr,
-        template <class T> class TDeleter,
-        template <class T> class THolder,
-        class TRefCounter,
-        class... TArgs>
-    typename std::enable_if<std::extent<TPtr>::value != 0, void>::type make_sync(
-            TArgs&&...)
-        = delete;
 
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
 
-    ///////////////////////////////////////////////////////////////////////////////////////////
-    //		MAKE WITH ALLOCATOR
-    ///////////////////////////////////////////////////////////////////////////////////////////
-    
-    template <
-        class TPtr,
-        template <class T> class TAllocator,
-        template <class T> class TDeleter = sync_ptr_deleter,
-        template <class T> class THolder = sync_ptr_holder,
-        class TRefCounter = sync_ptr_ref_counter,
-        class... TArgs>
-    inline typename std::enable_if<
-        !std::is_array<TPtr>::value, 
+    private:
+        typedef typename sync_ptr_type::body_t body_t;
+
+    private:
+        body_t *		body_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        /**
+        * \brief Borrow target chain.
+        */
+        sync_ref(
+            sync_ptr_type const & p_ptr)
+            noexcept
+            // Members.
+            : body_(p_ptr.body_)
+        {}
+
+        sync_ref(
+            sync_ref const & p_other)
+            noexcept = default;
+
+        inline sync_ref & operator=(
+            sync_ref const & p_other)
+            noexcept = default;
+
+
+    public:
+        /**
+        * \brief Return a sync_ptr sharing the borrowed chain.
+        */
+        inline sync_ptr_type sync(
+            void)
+            const noexcept
+        {
+            return sync_ptr_type(body_);
+        }
+
+        inline size_t count(
+            void)
+            const noexcept
+        {
+            return body_ ? body_->get_ref_count_ptr() : 0;
+        }
+
+
+    public:
+        inline TPtr * get(
+            void)
+            const noexcept
+        {
+            return body_ ? body_->get_ptr() : nullptr;
+        }
+
+        inline TPtr & operator*(
+            void)
+            const noexcept
+        {
+            return *get();
+        }
+
+        inline TPtr * operator->(
+            void)
+            const noexcept
+        {
+            return get();
+        }
+
+
+    public:
+        inline bool valid(
+            void)
+            const noexcept
+        {
+            return (get() != nullptr);
+        }
+
+        inline operator bool(
+            void)
+            const noexcept
+        {
+            return valid();
+        }
+
+    }; // class sync_ref
+
+
+    /**
+    * \class mem::sync_weak_ptr
+    *
+    * \brief Weak reference to a sync_ptr chain.
+    * Keeps the chain body alive through its reference count but not the pointee,
+    * which is still released with the last sync_ptr of the chain.
+    * lock() returns a sync_ptr joining the chain while the pointee is alive, an empty one otherwise.
+    *
+    * \note Needs a reference counter policy offering try_increment_ptr().
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter,
+        template <class T> class THolder,
+        class TRefCounter>
+    class sync_weak_ptr final
+    {
+
+    public:
+        typedef typename TPtr           pointer_type;
+        typedef typename sync_ptr<
+            TPtr,
+            TDeleter,
+            THolder,
+            TRefCounter>   sync_ptr_type;
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        typedef typename sync_ptr_type::body_t body_t;
+
+    private:
+        body_t *		body_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        constexpr sync_weak_ptr(
+            void)
+            noexcept
+            // Members.
+            : body_(nullptr)
+        {}
+
+        /**
+        * \brief Observe target chain.
+        */
+        sync_weak_ptr(
+            sync_ptr_type const & p_ptr)
+            noexcept
+            // Members.
+            : body_(p_ptr.body_)
+        {
+            if (body_)
+            {
+                body_->ref();
+            }
+        }
+
+        sync_weak_ptr(
+            sync_weak_ptr && p_other)
+            noexcept
+            // Members.
+            : body_(p_other.body_)
+        {
+            p_other.body_ = nullptr;
+        }
+
+        sync_weak_ptr(
+            sync_weak_ptr const & p_other)
+            noexcept
+            // Members.
+            : body_(p_other.body_)
+        {
+            if (body_)
+            {
+                body_->ref();
+            }
+        }
+
+        ~sync_weak_ptr(
+            void)
+            noexcept
+        {
+            if (body_)
+            {
+                body_->unref();
+            }
+        }
+
+        inline sync_weak_ptr & operator=(
+            sync_weak_ptr p_other)
+            noexcept
+        {
+            swap(p_other);
+            return *this;
+        }
+
+        void swap(
+            sync_weak_ptr & p_rhs)
+            noexcept
+        {
+            auto tmp = body_;
+            body_ = p_rhs.body_;
+            p_rhs.body_ = tmp;
+        }
+
+
+    public:
+        /**
+        * \brief Return a sync_ptr joining the chain, empty if the pointee was released with its last sync_ptr.
+        * A chain emptied by release() is joined like a copy would.
+        */
+        inline sync_ptr_type lock(
+            void)
+            const noexcept
+        {
+            sync_ptr_type ptr;
+            if (body_ && body_->try_ref_ptr())
+            {
+                body_->ref();
+                ptr.body_ = body_;
+            }
+            return ptr;
+        }
+
+        inline bool expired(
+            void)
+            const noexcept
+        {
+            return !body_ || body_->get_ref_count_ptr() == 0;
+        }
+
+        inline size_t count(
+            void)
+            const noexcept
+        {
+            return body_ ? body_->get_ref_count_ptr() : 0;
+        }
+
+    }; // class sync_weak_ptr
+
+
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    //		MAKE
+    ///////////////////////////////////////////////////////////////////////////////////////////
+
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class THolder = sync_ptr_holder,
+        class TRefCounter = sync_ptr_ref_counter,
+        class... TArgs>
+    inline typename std::enable_if<
+        !std::is_array<TPtr>::value, 
+        mem::sync_ptr<TPtr, TDeleter, THolder, TRefCounter>>::type
+        make_sync(
+            TArgs&&... p_args)
+    {
+        typedef typename sync_ptr<
+            TPtr,
+            TDeleter,
+            THolder,
+            TRefCounter> sync_ptr_t;
+        return (sync_ptr_t(new TPtr(std::forward<TArgs>(p_args)...)));
+    }
+
+    template<
+        class TPtr,
+        template <class T> class TDeleter,
+        template <class T> class THolder,
+        class TRefCounter,
+        class... TArgs>
+    typename std::enable_if<std::extent<TPtr>::value != 0, void>::type make_sync(
+            TArgs&&...)
+        = delete;
+
+
+    /**
+    * \brief Chain of an array of target number of value-initialized elements.
+    * Elements and their count share one allocation.
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class THolder = sync_ptr_holder,
+        class TRefCounter = sync_ptr_ref_counter>
+    inline typename std::enable_if<
+        std::is_array<TPtr>::value && std::extent<TPtr>::value == 0, 
+        mem::sync_ptr<TPtr, TDeleter, THolder, TRefCounter>>::type
+        make_sync(
+            size_t p_size)
+    {
+        typedef typename sync_ptr<
+            TPtr,
+            TDeleter,
+            THolder,
+            TRefCounter> sync_ptr_t;
+        typedef typename std::remove_extent<TPtr>::type element_t;
+        return (sync_ptr_t(array_block<element_t>::create(p_size)));
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    //		MAKE FOR OVERWRITE
+    ///////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * \brief Chain of a default-initialized pointee, trivial types are left uninitialized.
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class THolder = sync_ptr_holder,
+        class TRefCounter = sync_ptr_ref_counter>
+    inline typename std::enable_if<
+        !std::is_array<TPtr>::value, 
+        mem::sync_ptr<TPtr, TDeleter, THolder, TRefCounter>>::type
+        make_sync_for_overwrite(
+            void)
+    {
+        typedef typename sync_ptr<
+            TPtr,
+            TDeleter,
+            THolder,
+            TRefCounter> sync_ptr_t;
+        return (sync_ptr_t(new TPtr));
+    }
+
+    /**
+    * \brief Chain of an array of target number of default-initialized elements,
+    * for buffers fully written before being read.
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class THolder = sync_ptr_holder,
+        class TRefCounter = sync_ptr_ref_counter>
+    inline typename std::enable_if<
+        std::is_array<TPtr>::value && std::extent<TPtr>::value == 0, 
+        mem::sync_ptr<TPtr, TDeleter, THolder, TRefCounter>>::type
+        make_sync_for_overwrite(
+            size_t p_size)
+    {
+        typedef typename sync_ptr<
+            TPtr,
+            TDeleter,
+            THolder,
+            TRefCounter> sync_ptr_t;
+        typedef typename std::remove_extent<TPtr>::type element_t;
+        return (sync_ptr_t(array_block<element_t>::create_for_overwrite(p_size)));
+    }
+
+
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    //		MAKE IN PLACE
+    ///////////////////////////////////////////////////////////////////////////////////////////
+
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class THolder = sync_ptr_holder,
+        class TRefCounter = sync_ptr_ref_counter,
+        class... TArgs>
+    inline typename std::enable_if<
+        !std::is_array<TPtr>::value, 
+        mem::sync_ptr<TPtr, TDeleter, THolder, TRefCounter>>::type
+        make_sync_inplace(
+            TArgs&&... p_args)
+    {
+        typedef typename sync_ptr<
+            TPtr,
+            TDeleter,
+            THolder,
+            TRefCounter> sync_ptr_t;
+        return (sync_ptr_t(inplace, std::forward<TArgs>(p_args)...));
+    }
+
+    template<
+        class TPtr,
+        template <class T> class TDeleter,
+        template <class T> class THolder,
+        class TRefCounter,
+        class... TArgs>
+    typename std::enable_if<std::extent<TPtr>::value != 0, void>::type make_sync_inplace(
+            TArgs&&...)
+        = delete;
+
+
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    //		MAKE WITH ALLOCATOR
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    
+    template <
+        class TPtr,
+        template <class T> class TAllocator,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class THolder = sync_ptr_holder,
+        class TRefCounter = sync_ptr_ref_counter,
+        class... TArgs>
+    inline typename std::enable_if<
+        !std::is_array<TPtr>::value, 
         mem::sync_ptr<TPtr, TDeleter, THolder, TRefCounter>>::type
         make_sync_with_allocator(
             TAllocator<TPtr> const & p_allocator, 
@@ -584,6 +1818,62 @@ namespace mem
         TArgs&&...)
         = delete;
 
+
+    ///////////////////////////////////////////////////////////////////////////////////////////
+    //		ALLOCATE
+    ///////////////////////////////////////////////////////////////////////////////////////////
+
+    /**
+    * \brief Construct pointee and chain body in a single block obtained from target allocator.
+    * Works with any standard conforming allocator, like std::allocate_shared.
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class THolder = sync_ptr_holder,
+        class TRefCounter = sync_ptr_ref_counter,
+        class TAlloc,
+        class... TArgs>
+    inline typename std::enable_if<
+        !std::is_array<TPtr>::value, 
+        mem::sync_ptr<TPtr, TDeleter, THolder, TRefCounter>>::type
+        allocate_sync(
+            TAlloc const & p_alloc, 
+            TArgs&&... p_args)
+    {
+        typedef typename sync_ptr<
+            TPtr,
+            TDeleter,
+            THolder,
+            TRefCounter> sync_ptr_t;
+        return (sync_ptr_t(std::allocator_arg, p_alloc, std::forward<TArgs>(p_args)...));
+    }
+
+#if defined(SYNC_PTR_PMR)
+    /**
+    * \brief Construct pointee and chain body from target memory resource.
+    * Uses-allocator pointees (std::pmr containers) allocate from the same resource.
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class THolder = sync_ptr_holder,
+        class TRefCounter = sync_ptr_ref_counter,
+        class TResource,
+        class... TArgs>
+    inline typename std::enable_if<
+        !std::is_array<TPtr>::value && std::is_base_of<std::pmr::memory_resource, TResource>::value, 
+        mem::sync_ptr<TPtr, TDeleter, THolder, TRefCounter>>::type
+        make_sync(
+            TResource * p_resource, 
+            TArgs&&... p_args)
+    {
+        return (allocate_sync<TPtr, TDeleter, THolder, TRefCounter>(
+            std::pmr::polymorphic_allocator<TPtr>(p_resource), 
+            std::forward<TArgs>(p_args)...));
+    }
+#endif // SYNC_PTR_PMR
+
 } // namespace mem
 
 
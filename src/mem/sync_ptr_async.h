@@ -0,0 +1,259 @@
+
+#ifndef __MEMORY_SYNC_PTR_ASYNC_H__
+#define __MEMORY_SYNC_PTR_ASYNC_H__
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifndef __MEMORY_SYNC_PTR_H__
+#include "mem/sync_ptr.h"
+#endif
+
+
+namespace mem
+{
+
+    /**
+    * \class mem::async_pool
+    *
+    * \brief Fixed size worker thread pool running posted tasks in FIFO order.
+    * Built-in executor of reset_async(), any type with a post(task) method can be used instead.
+    * Destruction runs every pending task then joins the workers.
+    */
+    class async_pool final
+    {
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        std::mutex                          mutex_;
+        std::condition_variable             cv_;
+        std::deque<std::function<void()>>   tasks_;
+        std::vector<std::thread>            workers_;
+        bool                                stop_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        async_pool(async_pool const &) = delete;
+        async_pool(async_pool &&) = delete;
+        void operator=(async_pool const &) = delete;
+        void operator=(async_pool &&) = delete;
+
+    public:
+        /**
+        * \brief Start target number of workers, one per hardware thread by default.
+        */
+        explicit async_pool(
+            size_t p_workers = (std::max)(1U, std::thread::hardware_concurrency()))
+            // Members.
+            : stop_(false)
+        {
+            workers_.reserve(p_workers);
+            for (size_t i = 0; i < p_workers; ++i)
+            {
+                workers_.emplace_back([this]() { run(); });
+            }
+        }
+
+        ~async_pool(
+            void)
+        {
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                stop_ = true;
+            }
+            cv_.notify_all();
+            for (auto & w : workers_)
+            {
+                w.join();
+            }
+        }
+
+
+    public:
+        /**
+        * \brief Process wide pool, started on first use.
+        */
+        static async_pool & instance(
+            void)
+        {
+            static async_pool pool;
+            return pool;
+        }
+
+        /**
+        * \brief Queue target task.
+        */
+        template<
+            class TTask>
+        void post(
+            TTask && p_task)
+        {
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                tasks_.emplace_back(std::forward<TTask>(p_task));
+            }
+            cv_.notify_one();
+        }
+
+        inline size_t size(
+            void)
+            const noexcept
+        {
+            return workers_.size();
+        }
+
+
+    private:
+        void run(
+            void)
+        {
+            for (;;)
+            {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> guard(mutex_);
+                    cv_.wait(guard, [this]() { return stop_ || !tasks_.empty(); });
+                    if (tasks_.empty())
+                    {
+                        return;
+                    }
+                    task = std::move(tasks_.front());
+                    tasks_.pop_front();
+                }
+                task();
+            }
+        }
+
+    }; // class async_pool
+
+
+    /**
+    * \brief Build a new pointer on target executor and publish it to target chain once built.
+    * The factory returns the new pointer (or null) and runs off the calling thread,
+    * p_publish(chain, pointer) publishes it.
+    * The result is stale and freed instead of published when the chain version moved since
+    * this call (reset, release, exchange, notify or an earlier reset_async completion),
+    * a change racing with the publish itself is not detected and the last one wins.
+    * The returned future holds true once published, false if stale, and carries factory exceptions.
+    * Executors are any type with a post(task) method, the task keeps the chain alive.
+    * Throw std::invalid_argument if target sync_ptr is empty.
+    */
+    template<
+        class TChain,
+        class TExecutor,
+        class TFactory,
+        class TPublish>
+    std::future<bool> post_reset(
+        TChain const & p_chain,
+        TExecutor & p_executor,
+        TFactory && p_factory,
+        TPublish p_publish)
+    {
+        if (p_chain.count() == 0)
+        {
+            throw std::invalid_argument("reset_async needs a sync_ptr linked to a chain.");
+        }
+        auto version = p_chain.version();
+        auto done = std::make_shared<std::promise<bool>>();
+        auto result = done->get_future();
+        p_executor.post(
+            [chain = p_chain, version, factory = std::forward<TFactory>(p_factory), publish = std::move(p_publish), done]() mutable
+            {
+                bool published = false;
+                try
+                {
+                    auto p = factory();
+                    if (chain.version() == version)
+                    {
+                        publish(chain, p);
+                        published = true;
+                    }
+                    else if (p)
+                    {
+                        // Stale, free through a chain of its own so the deleter policy applies.
+                        TChain stale(p);
+                    }
+                }
+                catch (...)
+                {
+                    done->set_exception(std::current_exception());
+                    return;
+                }
+                done->set_value(published);
+            });
+        return result;
+    }
+
+    /**
+    * \brief Build a new pointer on target executor and reset target chain to it once built,
+    * readers keep the current pointer until it is published. See post_reset().
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter,
+        template <class T> class THolder,
+        class TRefCounter,
+        class TExecutor,
+        class TFactory>
+    std::future<bool> reset_async(
+        sync_ptr<TPtr, TDeleter, THolder, TRefCounter> const & p_chain,
+        TExecutor & p_executor,
+        TFactory && p_factory)
+    {
+        return post_reset(
+            p_chain,
+            p_executor,
+            std::forward<TFactory>(p_factory),
+            [](sync_ptr<TPtr, TDeleter, THolder, TRefCounter> & p_target, TPtr * p_ptr)
+            {
+                if (p_ptr)
+                {
+                    p_target.reset(p_ptr);
+                }
+                else
+                {
+                    p_target.reset();
+                }
+            });
+    }
+
+    /**
+    * \brief Build a new pointer on the process wide async_pool, see above.
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter,
+        template <class T> class THolder,
+        class TRefCounter,
+        class TFactory>
+    std::future<bool> reset_async(
+        sync_ptr<TPtr, TDeleter, THolder, TRefCounter> const & p_chain,
+        TFactory && p_factory)
+    {
+        return reset_async(
+            p_chain,
+            async_pool::instance(),
+            std::forward<TFactory>(p_factory));
+    }
+
+} // namespace mem
+
+#endif // __MEMORY_SYNC_PTR_ASYNC_H__
@@ -0,0 +1,590 @@
+
+#ifndef __MEMORY_SYNC_PTR_BIASED_H__
+#define __MEMORY_SYNC_PTR_BIASED_H__
+
+#include <cassert>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <new>
+
+
+namespace mem
+{
+
+    /**
+    * \brief Biased reference counter (BRC).
+    * The thread constructing the counter owns it and counts on biased counters
+    * with plain loads and stores, other threads count on atomic shared counters.
+    *
+    * Shared counters hold (count << 2) | queued << 1 | merged.
+    * When the owner drops its biased count to zero it merges both counts into the shared ones
+    * and the counter behaves as a plain atomic counter from then on.
+    * When another thread drives a shared count negative, the counter is queued to its owner,
+    * which merges it on its next counting operation or on exit.
+    * If the owner already exited, the queuing thread merges it itself.
+    *
+    * Releases detected during a deferred merge are reported through the callback set with bind(),
+    * decrement() and decrement_ptr() only return 1 for releases detected synchronously.
+    * Their return value is otherwise 2 and does not reflect the previous count.
+    *
+    * \note Owner thread records are recycled once their thread exited and no counter points to them.
+    * A thread that can't get a record creates counters counting on the shared counters only.
+    */
+    class biased_ref_counter
+    {
+
+    public:
+        typedef void (*release_t)(biased_ref_counter *, bool p_ptr);
+#ifdef SYNC_PTR_TEST_HOOKS
+        typedef void (*hook_t)(biased_ref_counter *);
+#endif
+
+
+    private:
+        /**
+        * \brief Owner thread record, receives counters queued for merge.
+        * Referenced by its thread and by every counter it owns, reusable once unreferenced.
+        */
+        struct record
+        {
+            std::atomic<biased_ref_counter *>   head_;
+            std::atomic<size_t>                 refs_;
+            record *                            next_;
+            bool                                draining_;
+
+            record(
+                void)
+                noexcept
+                : head_(nullptr)
+                , refs_(1U)
+                , next_(nullptr)
+                , draining_(false)
+            {}
+        };
+
+        /**
+        * \brief Thread record owner, closes the queue on thread exit.
+        * Record is null until one could be acquired.
+        */
+        struct local
+        {
+            record *    record_;
+
+            local(
+                void)
+                noexcept
+                : record_(acquire_record())
+            {}
+
+            ~local(
+                void)
+            {
+                if (!record_)
+                {
+                    return;
+                }
+                for (;;)
+                {
+                    drain(record_);
+                    biased_ref_counter * expected = nullptr;
+                    if (record_->head_.compare_exchange_strong(
+                        expected,
+                        closed(),
+                        std::memory_order_acq_rel))
+                    {
+                        break;
+                    }
+                }
+                unref(record_);
+            }
+        };
+
+        struct biased_count
+        {
+            std::atomic<size_t>         biased_;
+            std::atomic<std::intptr_t>  shared_;
+
+            biased_count(
+                size_t p_biased)
+                noexcept
+                : biased_(p_biased)
+                , shared_(0)
+            {}
+        };
+
+        static constexpr std::intptr_t merged = 1;
+        static constexpr std::intptr_t queued = 2;
+        static constexpr std::intptr_t one = 4;
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        std::atomic<record *>   owner_;
+        biased_count            ref_count_;
+        biased_count            ref_count_ptr_;
+        std::atomic<bool>       enqueued_;
+        biased_ref_counter *    next_;
+        release_t               release_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        biased_ref_counter(biased_ref_counter const &) = delete;
+        void operator=(biased_ref_counter const &) = delete;
+
+    public:
+        inline biased_ref_counter(
+            void)
+            noexcept
+            : owner_(local_record())
+            , ref_count_(1U)
+            , ref_count_ptr_(0)
+            , enqueued_(false)
+            , next_(nullptr)
+            , release_(nullptr)
+        {
+            auto * rec = owner_.load(std::memory_order_relaxed);
+            if (rec)
+            {
+                rec->refs_.fetch_add(1U, std::memory_order_relaxed);
+                return;
+            }
+
+            // No record, start merged and count on shared counters only.
+            ref_count_.biased_.store(0, std::memory_order_relaxed);
+            ref_count_.shared_.store(one | merged, std::memory_order_relaxed);
+            ref_count_ptr_.shared_.store(merged, std::memory_order_relaxed);
+        }
+
+        inline ~biased_ref_counter(
+            void)
+        {
+            auto * rec = owner_.load(std::memory_order_relaxed);
+            if (rec)
+            {
+                unref(rec);
+            }
+        }
+
+        /**
+        * \brief Set callback reporting releases detected during a deferred merge.
+        */
+        inline void bind(
+            release_t p_release)
+            noexcept
+        {
+            release_ = p_release;
+        }
+
+#ifdef SYNC_PTR_TEST_HOOKS
+        /**
+        * \brief Test hook run by the owner right after it merged on its last biased release.
+        */
+        static hook_t & merged_hook(
+            void)
+            noexcept
+        {
+            static hook_t hook = nullptr;
+            return hook;
+        }
+
+        /**
+        * \brief Number of owner thread records ever allocated.
+        */
+        static size_t record_count(
+            void)
+            noexcept
+        {
+            size_t n = 0;
+            for (auto * rec = records().load(std::memory_order_acquire); rec; rec = rec->next_)
+            {
+                ++n;
+            }
+            return n;
+        }
+#endif
+
+    public:
+        inline void increment(
+            void)
+            noexcept
+        {
+            add(ref_count_);
+        }
+
+        inline size_t decrement(
+            void)
+            noexcept
+        {
+            return sub(ref_count_) ? 1U : 2U;
+        }
+
+        inline void increment_ptr(
+            void)
+            noexcept
+        {
+            add(ref_count_ptr_);
+        }
+
+        inline size_t decrement_ptr(
+            void)
+            noexcept
+        {
+            return sub(ref_count_ptr_) ? 1U : 2U;
+        }
+
+        inline size_t count(
+            void)
+            const noexcept
+        {
+            return total(ref_count_);
+        }
+
+        inline size_t count_ptr(
+            void)
+            const noexcept
+        {
+            return total(ref_count_ptr_);
+        }
+
+
+    private:
+        static biased_ref_counter * closed(
+            void)
+            noexcept
+        {
+            return reinterpret_cast<biased_ref_counter *>(std::uintptr_t(1U));
+        }
+
+        /**
+        * \brief Calling thread record, null while none can be acquired.
+        */
+        static record * local_record(
+            void)
+            noexcept
+        {
+            static thread_local local l;
+            if (!l.record_)
+            {
+                l.record_ = acquire_record();
+            }
+            return l.record_;
+        }
+
+        /**
+        * \brief Every record ever allocated, records are recycled and never freed.
+        */
+        static std::atomic<record *> & records(
+            void)
+            noexcept
+        {
+            static std::atomic<record *> head(nullptr);
+            return head;
+        }
+
+        /**
+        * \brief Reuse an unreferenced record or allocate one, return null when out of memory.
+        */
+        static record * acquire_record(
+            void)
+            noexcept
+        {
+            for (auto * rec = records().load(std::memory_order_acquire); rec; rec = rec->next_)
+            {
+                size_t unused = 0;
+                if (rec->refs_.load(std::memory_order_relaxed) == 0 &&
+                    rec->refs_.compare_exchange_strong(unused, 1U, std::memory_order_acquire))
+                {
+                    // Reopen the queue, late pushes are merged by the new owner.
+                    rec->head_.store(nullptr, std::memory_order_release);
+                    return rec;
+                }
+            }
+
+            auto * rec = new (std::nothrow) record();
+            if (!rec)
+            {
+                return nullptr;
+            }
+            auto * head = records().load(std::memory_order_relaxed);
+            do
+            {
+                rec->next_ = head;
+            } while (!records().compare_exchange_weak(
+                head,
+                rec,
+                std::memory_order_release,
+                std::memory_order_relaxed));
+            return rec;
+        }
+
+        static void unref(
+            record * p_record)
+            noexcept
+        {
+            p_record->refs_.fetch_sub(1U, std::memory_order_acq_rel);
+        }
+
+        static std::intptr_t shared_count(
+            std::intptr_t p_value)
+            noexcept
+        {
+            return (p_value - (p_value & (merged | queued))) / one;
+        }
+
+        static size_t total(
+            biased_count const & p_count)
+            noexcept
+        {
+            auto n = static_cast<std::intptr_t>(p_count.biased_.load(std::memory_order_relaxed)) +
+                shared_count(p_count.shared_.load(std::memory_order_acquire));
+            return n > 0 ? static_cast<size_t>(n) : 0U;
+        }
+
+        /**
+        * \brief Return true if calling thread owns the biased counts.
+        * Drains the owner queue first.
+        */
+        inline bool owned(
+            void)
+            noexcept
+        {
+            auto * rec = local_record();
+            if (!rec || owner_.load(std::memory_order_relaxed) != rec)
+            {
+                return false;
+            }
+            if (rec->head_.load(std::memory_order_relaxed))
+            {
+                drain(rec);
+            }
+            return owner_.load(std::memory_order_relaxed) == rec;
+        }
+
+        inline void add(
+            biased_count & p_count)
+            noexcept
+        {
+            if (owned())
+            {
+                p_count.biased_.store(
+                    p_count.biased_.load(std::memory_order_relaxed) + 1U,
+                    std::memory_order_relaxed);
+            }
+            else
+            {
+                p_count.shared_.fetch_add(one, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+        * \brief Decrement target count, return true if it was the last reference.
+        */
+        inline bool sub(
+            biased_count & p_count)
+            noexcept
+        {
+            if (owned())
+            {
+                auto b = p_count.biased_.load(std::memory_order_relaxed) - 1U;
+                p_count.biased_.store(b, std::memory_order_relaxed);
+                if (b > 0)
+                {
+                    return false;
+                }
+
+                // Owner abandons the counter, only the merging RMW tells if it was the last reference:
+                // a non-owner may release right after it.
+                auto v = merge(&p_count);
+#ifdef SYNC_PTR_TEST_HOOKS
+                if (merged_hook())
+                {
+                    merged_hook()(this);
+                }
+#endif
+                return !(v & queued) && shared_count(v) == 0;
+            }
+
+            auto v = p_count.shared_.fetch_sub(one, std::memory_order_acq_rel) - one;
+            if (v & merged)
+            {
+                return !(v & queued) && shared_count(v) == 0;
+            }
+            if (shared_count(v) >= 0 || (v & queued))
+            {
+                return false;
+            }
+
+            auto old = p_count.shared_.fetch_or(queued, std::memory_order_acq_rel);
+            if (old & queued)
+            {
+                return false;
+            }
+            if (old & merged)
+            {
+                return unqueue(p_count);
+            }
+            if (enqueued_.exchange(true, std::memory_order_acq_rel))
+            {
+                return false;
+            }
+            if (&p_count != &ref_count_)
+            {
+                // Keep this alive until the queued counter is processed.
+                ref_count_.shared_.fetch_or(queued, std::memory_order_acq_rel);
+            }
+
+            auto * rec = owner_.load(std::memory_order_acquire);
+            if (rec && push(rec))
+            {
+                return false;
+            }
+
+            // Owner exited or already merged, process in place.
+            bool ptr_last = false;
+            bool ref_last = false;
+            process(ptr_last, ref_last);
+            if (&p_count == &ref_count_)
+            {
+                if (ptr_last)
+                {
+                    notify(true);
+                }
+                return ref_last;
+            }
+            assert(!ref_last);
+            return ptr_last;
+        }
+
+        /**
+        * \brief Fold biased counts into shared ones, owner thread or dead owner only.
+        * Return the shared value of target count right after its merge.
+        */
+        inline std::intptr_t merge(
+            biased_count const * p_count = nullptr)
+            noexcept
+        {
+            auto * rec = owner_.load(std::memory_order_relaxed);
+            if (!rec)
+            {
+                return p_count ? p_count->shared_.load(std::memory_order_acquire) : 0;
+            }
+            std::intptr_t result = 0;
+            for (auto * c : { &ref_count_ptr_, &ref_count_ })
+            {
+                auto b = static_cast<std::intptr_t>(c->biased_.load(std::memory_order_relaxed));
+                c->biased_.store(0, std::memory_order_relaxed);
+                auto v = c->shared_.load(std::memory_order_relaxed);
+                auto add = b * one + ((v & merged) ? 0 : merged);
+                v = c->shared_.fetch_add(add, std::memory_order_acq_rel) + add;
+                if (c == p_count)
+                {
+                    result = v;
+                }
+            }
+            owner_.store(nullptr, std::memory_order_release);
+            unref(rec);
+            return result;
+        }
+
+        /**
+        * \brief Clear queued flag, return true if target count is then released.
+        */
+        static bool unqueue(
+            biased_count & p_count)
+            noexcept
+        {
+            auto v = p_count.shared_.load(std::memory_order_relaxed);
+            while (!p_count.shared_.compare_exchange_weak(
+                v,
+                v & ~queued,
+                std::memory_order_acq_rel))
+            {}
+            return (v & queued) && (v & merged) && shared_count(v) == 0;
+        }
+
+        inline void process(
+            bool & p_ptr_last,
+            bool & p_ref_last)
+            noexcept
+        {
+            merge();
+            p_ptr_last = unqueue(ref_count_ptr_);
+            p_ref_last = unqueue(ref_count_);
+        }
+
+        inline void notify(
+            bool p_ptr)
+            noexcept
+        {
+            assert(release_);
+            release_(this, p_ptr);
+        }
+
+        inline bool push(
+            record * p_record)
+            noexcept
+        {
+            auto * head = p_record->head_.load(std::memory_order_acquire);
+            do
+            {
+                if (head == closed())
+                {
+                    return false;
+                }
+                next_ = head;
+            } while (!p_record->head_.compare_exchange_weak(
+                head,
+                this,
+                std::memory_order_acq_rel,
+                std::memory_order_acquire));
+            return true;
+        }
+
+        /**
+        * \brief Merge every counter queued to target owner record.
+        */
+        static void drain(
+            record * p_record)
+            noexcept
+        {
+            if (p_record->draining_)
+            {
+                return;
+            }
+            p_record->draining_ = true;
+            while (auto * node = p_record->head_.exchange(nullptr, std::memory_order_acq_rel))
+            {
+                while (node)
+                {
+                    auto * next = node->next_;
+                    bool ptr_last = false;
+                    bool ref_last = false;
+                    node->process(ptr_last, ref_last);
+                    if (ptr_last)
+                    {
+                        node->notify(true);
+                    }
+                    if (ref_last)
+                    {
+                        node->notify(false);
+                    }
+                    node = next;
+                }
+            }
+            p_record->draining_ = false;
+        }
+
+    }; // class biased_ref_counter
+
+} // namespace mem
+
+#endif // __MEMORY_SYNC_PTR_BIASED_H__
@@ -0,0 +1,185 @@
+
+#ifndef __MEMORY_SYNC_PTR_BRAVO_H__
+#define __MEMORY_SYNC_PTR_BRAVO_H__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+
+namespace mem
+{
+
+    /**
+    * \brief Visible readers table shared by every reader-biased holder.
+    * Each slot sits on its own cache line, a reader only writes the slot its thread hashes to.
+    */
+    class bravo_table final
+    {
+
+    public:
+        static constexpr size_t slot_count = 1024U;
+
+        struct alignas(64) slot
+        {
+            std::atomic<void const *>   owner_;
+        };
+
+    public:
+        static slot * slots(
+            void)
+            noexcept
+        {
+            static slot table[slot_count] = {};
+            return table;
+        }
+
+        /**
+        * \brief Slot of the calling thread for target lock.
+        */
+        static slot & at(
+            void const * p_lock)
+            noexcept
+        {
+            static thread_local size_t const thread_hash = 
+                std::hash<std::thread::id>()(std::this_thread::get_id());
+            auto h = (thread_hash ^ (reinterpret_cast<std::uintptr_t>(p_lock) >> 4U)) 
+                * size_t(0x9E3779B97F4A7C15ULL);
+            return slots()[(h >> 20U) % slot_count];
+        }
+
+    }; // class bravo_table
+
+
+    /**
+    * \brief Reader-biased pointer holder (BRAVO).
+    * While biased, get() publishes itself in the visible readers table instead of 
+    * taking the lock, concurrent readers never write a shared cache line.
+    * set() revokes the bias, waits for published readers to drain
+    * and updates the pointer under the underlying reader/writer lock.
+    * The bias stays off for inhibit_factor times the revocation time, so frequent writers don't scan
+    * the table on every set(), the first reader through the lock past that deadline restores it.
+    */
+    template <class TPtr>
+    class ptr_holder_bravo
+    {
+
+    public:
+        /** \brief Bias inhibition time, in revocation times. */
+        static constexpr unsigned inhibit_factor = 9U;
+
+    private:
+        typedef std::chrono::steady_clock clock_t;
+
+    private:
+        TPtr *                              ptr_;
+        mutable std::atomic<bool>           bias_;
+        std::atomic<clock_t::rep>           inhibit_until_;
+        mutable std::shared_timed_mutex     mtx_;
+
+    public:
+        inline ptr_holder_bravo(
+            void)
+            noexcept
+            : ptr_(nullptr)
+            , bias_(true)
+            , inhibit_until_(0)
+            , mtx_()
+        {}
+
+        inline explicit ptr_holder_bravo(
+            TPtr * p_ptr)
+            noexcept
+            : ptr_(p_ptr)
+            , bias_(true)
+            , inhibit_until_(0)
+            , mtx_()
+        {}
+
+        inline TPtr * set(
+            TPtr * p_ptr)
+            noexcept
+        {
+            std::lock_guard<std::shared_timed_mutex> l(mtx_);
+            if (bias_.load(std::memory_order_relaxed))
+            {
+                auto start = clock_t::now();
+                revoke();
+                auto now = clock_t::now();
+                inhibit_until_.store(
+                    (now + (now - start) * inhibit_factor).time_since_epoch().count(),
+                    std::memory_order_relaxed);
+            }
+            auto p = ptr_;
+            ptr_ = p_ptr;
+            return p;
+        }
+
+        /**
+        * \brief Return true if readers currently take the fast path.
+        */
+        inline bool biased(
+            void)
+            const noexcept
+        {
+            return bias_.load(std::memory_order_relaxed);
+        }
+
+        inline TPtr * get(
+            void)
+            const noexcept
+        {
+            if (bias_.load())
+            {
+                auto & slot = bravo_table::at(this);
+                void const * expected = nullptr;
+                if (slot.owner_.compare_exchange_strong(expected, this))
+                {
+                    if (bias_.load())
+                    {
+                        auto p = ptr_;
+                        slot.owner_.store(nullptr, std::memory_order_release);
+                        return p;
+                    }
+                    slot.owner_.store(nullptr, std::memory_order_release);
+                }
+            }
+
+            std::shared_lock<std::shared_timed_mutex> l(mtx_);
+            if (!bias_.load(std::memory_order_relaxed) &&
+                clock_t::now().time_since_epoch().count() >= inhibit_until_.load(std::memory_order_relaxed))
+            {
+                // No writer while the lock is shared, the next set() revokes again.
+                bias_.store(true);
+            }
+            return ptr_;
+        }
+
+    private:
+        /**
+        * \brief Disable bias and wait for fast path readers of this to leave.
+        */
+        inline void revoke(
+            void)
+            noexcept
+        {
+            bias_.store(false);
+            auto * slots = bravo_table::slots();
+            for (size_t i = 0; i < bravo_table::slot_count; ++i)
+            {
+                while (slots[i].owner_.load() == this)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+    }; // class ptr_holder_bravo
+
+} // namespace mem
+
+#endif // __MEMORY_SYNC_PTR_BRAVO_H__
@@ -0,0 +1,121 @@
+
+#ifndef __MEMORY_SYNC_PTR_CACHED_H__
+#define __MEMORY_SYNC_PTR_CACHED_H__
+
+#include <atomic>
+#include <cstddef>
+
+
+namespace mem
+{
+
+    /**
+    * \class mem::cached_reader
+    *
+    * \brief Per-thread cached read access to a sync_ptr chain (either flavor).
+    * Keeps the last read pointer with the chain version it was read at,
+    * get() only goes through the pointer holder again once the version changed.
+    * A cache hit costs one relaxed load instead of the holder read (a recursive mutex lock for ptr_holder_ts).
+    *
+    * Meant to be owned by a single thread, typically declared thread_local.
+    * The reader holds a sync_ptr to the chain, copies of the chain joined later are followed as usual.
+    *
+    * \note Like get(), returned pointers are only protected from concurrent updates by the deleter policy.
+    */
+    template<
+        class TSyncPtr>
+    class cached_reader final
+    {
+
+    public:
+        typedef typename TSyncPtr::pointer_type     pointer_type;
+        typedef TSyncPtr                            sync_ptr_type;
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        sync_ptr_type           chain_;
+        mutable pointer_type *  ptr_;
+        mutable size_t          version_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        /**
+        * \brief Read through target chain.
+        */
+        explicit cached_reader(
+            sync_ptr_type const & p_chain)
+            noexcept
+            // Members.
+            : chain_(p_chain)
+            , version_(chain_.version())
+        {
+            ptr_ = chain_.get();
+        }
+
+
+    public:
+        inline pointer_type * get(
+            void)
+            const noexcept
+        {
+            auto v = chain_.version(std::memory_order_relaxed);
+            if (v != version_)
+            {
+                // Holder read must not see an older pointer than the version.
+                std::atomic_thread_fence(std::memory_order_acquire);
+                version_ = v;
+                ptr_ = chain_.get();
+            }
+            return ptr_;
+        }
+
+        inline pointer_type & operator*(
+            void)
+            const noexcept
+        {
+            return *get();
+        }
+
+        inline pointer_type * operator->(
+            void)
+            const noexcept
+        {
+            return get();
+        }
+
+        inline sync_ptr_type const & chain(
+            void)
+            const noexcept
+        {
+            return chain_;
+        }
+
+
+    public:
+        inline bool valid(
+            void)
+            const noexcept
+        {
+            return (get() != nullptr);
+        }
+
+        inline operator bool(
+            void)
+            const noexcept
+        {
+            return valid();
+        }
+
+    }; // class cached_reader
+
+} // namespace mem
+
+#endif // __MEMORY_SYNC_PTR_CACHED_H__
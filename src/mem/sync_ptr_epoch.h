@@ -0,0 +1,523 @@
+
+#ifndef __MEMORY_SYNC_PTR_EPOCH_H__
+#define __MEMORY_SYNC_PTR_EPOCH_H__
+
+#include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+namespace mem
+{
+
+    /**
+    * \class mem::epoch_domain
+    *
+    * \brief Epoch based reclamation registry.
+    * Reader threads announce the global epoch they observed while inside a read-side section.
+    * Pointers retired during epoch E are freed once the global epoch reached E + 2,
+    * which implies every reader active during E has left its section.
+    * Retiring never allocates past memory exhaustion: the calling thread then waits
+    * for a grace period and frees the pointer in place, it must not be inside a read-side section.
+    */
+    class epoch_domain final
+    {
+
+    public:
+        typedef void (*free_t)(void *);
+
+        /** \brief Retired pointers count between two reclamation attempts. */
+        static constexpr size_t collect_threshold = 64U;
+
+
+    private:
+        struct retired
+        {
+            void *      ptr_;
+            free_t      free_;
+            size_t      epoch_;
+        };
+
+        /**
+        * \brief Per-thread announced epoch and retire list.
+        * Announced epoch is shifted left, low bit set while inside a read-side section.
+        * Records are never freed before the domain, inactive ones are recycled.
+        */
+        struct record
+        {
+            std::atomic<size_t>         epoch_;
+            std::atomic<bool>           active_;
+            record *                    next_;
+            size_t                      nesting_;
+            size_t                      retire_count_;
+            bool                        collecting_;
+            std::vector<retired>        retired_;
+
+            record(
+                void)
+                noexcept
+                : epoch_(0)
+                , active_(true)
+                , next_(nullptr)
+                , nesting_(0)
+                , retire_count_(0)
+                , collecting_(false)
+            {}
+        };
+
+        /**
+        * \brief Thread record owner, gives the record back on thread exit.
+        * Record is null until one could be allocated.
+        */
+        struct local
+        {
+            epoch_domain &      domain_;
+            record *            record_;
+
+            explicit local(
+                epoch_domain & p_domain)
+                noexcept
+                : domain_(p_domain)
+                , record_(nullptr)
+            {}
+
+            ~local(
+                void)
+            {
+                if (record_)
+                {
+                    domain_.release_record(record_);
+                }
+            }
+        };
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        std::atomic<size_t>         epoch_;
+        std::atomic<record *>       head_;
+        std::mutex                  orphans_mtx_;
+        std::vector<retired>        orphans_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        epoch_domain(epoch_domain const &) = delete;
+        epoch_domain(epoch_domain &&) = delete;
+        void operator=(epoch_domain const &) = delete;
+        void operator=(epoch_domain &&) = delete;
+
+    private:
+        epoch_domain(
+            void)
+            noexcept
+            : epoch_(0)
+            , head_(nullptr)
+        {}
+
+    public:
+        ~epoch_domain(
+            void)
+        {
+            auto * rec = head_.load();
+            while (rec)
+            {
+                auto * next = rec->next_;
+                free_all(rec->retired_);
+                delete rec;
+                rec = next;
+            }
+            free_all(orphans_);
+        }
+
+        static epoch_domain & instance(
+            void)
+        {
+            static epoch_domain domain;
+            return domain;
+        }
+
+
+    public:
+        /**
+        * \brief Enter a read-side section on the calling thread.
+        * Sections nest, only the outermost one announces the epoch.
+        */
+        inline void enter(
+            void)
+        {
+            auto * rec = local_record();
+            if (!rec)
+            {
+                throw std::bad_alloc();
+            }
+            if (rec->nesting_++ == 0)
+            {
+                rec->epoch_.store(
+                    (epoch_.load(std::memory_order_relaxed) << 1U) | 1U,
+                    std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+
+        /**
+        * \brief Leave a read-side section on the calling thread.
+        */
+        inline void leave(
+            void)
+            noexcept
+        {
+            auto * rec = local_record();
+            assert(rec && rec->nesting_ > 0);
+            if (--rec->nesting_ == 0)
+            {
+                rec->epoch_.store(0, std::memory_order_release);
+            }
+        }
+
+        /**
+        * \brief Return true if the calling thread is inside a read-side section.
+        */
+        inline bool in_section(
+            void)
+            noexcept
+        {
+            auto * rec = local_record();
+            return rec && rec->nesting_ > 0;
+        }
+
+
+    public:
+        /**
+        * \brief Defer free of target pointer until every reader active in the current epoch left.
+        */
+        template<
+            class TType>
+        void retire(
+            TType * p_ptr)
+            noexcept
+        {
+            retire(
+                const_cast<typename std::remove_cv<TType>::type *>(p_ptr),
+                &delete_ptr<typename std::remove_cv<TType>::type>);
+        }
+
+        void retire(
+            void * p_ptr,
+            free_t p_free)
+            noexcept
+        {
+            auto * rec = local_record();
+            try
+            {
+                if (!rec)
+                {
+                    throw std::bad_alloc();
+                }
+                rec->retired_.push_back(retired{ p_ptr, p_free, epoch_.load() });
+            }
+            catch (...)
+            {
+                assert((!rec || rec->nesting_ == 0) && "Retired pointer may be read by the calling thread.");
+                synchronize();
+                p_free(p_ptr);
+                return;
+            }
+            if (++rec->retire_count_ >= collect_threshold)
+            {
+                rec->retire_count_ = 0;
+                try_advance();
+                collect(rec);
+            }
+        }
+
+        /**
+        * \brief Try to advance the epoch and free every retired pointer no reader can reach.
+        */
+        void reclaim(
+            void)
+            noexcept
+        {
+            try_advance();
+            auto * rec = local_record();
+            if (rec)
+            {
+                collect(rec);
+            }
+        }
+
+        /**
+        * \brief Wait until every read-side section active at call time has ended.
+        * Must not be called from inside a read-side section.
+        */
+        void synchronize(
+            void)
+            noexcept
+        {
+            assert(!in_section());
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            auto target = epoch_.load() + 2U;
+            while (epoch_.load() < target)
+            {
+                if (!try_advance())
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        /**
+        * \brief Number of retired pointers awaiting reclamation on the calling thread.
+        */
+        size_t pending(
+            void)
+            noexcept
+        {
+            auto * rec = local_record();
+            return rec ? rec->retired_.size() : 0;
+        }
+
+        inline size_t epoch(
+            void)
+            const noexcept
+        {
+            return epoch_.load();
+        }
+
+
+    private:
+        template<
+            class TType>
+        static void delete_ptr(
+            void * p_ptr)
+        {
+            delete static_cast<TType *>(p_ptr);
+        }
+
+        static void free_all(
+            std::vector<retired> & p_list)
+            noexcept
+        {
+            for (auto & r : p_list)
+            {
+                r.free_(r.ptr_);
+            }
+            p_list.clear();
+        }
+
+        /**
+        * \brief Calling thread record, null while none can be allocated.
+        */
+        record * local_record(
+            void)
+            noexcept
+        {
+            static thread_local local l(*this);
+            if (!l.record_)
+            {
+                l.record_ = acquire_record();
+            }
+            return l.record_;
+        }
+
+        record * acquire_record(
+            void)
+            noexcept
+        {
+            for (auto * rec = head_.load(); rec; rec = rec->next_)
+            {
+                bool active = false;
+                if (!rec->active_.load(std::memory_order_relaxed) &&
+                    rec->active_.compare_exchange_strong(active, true))
+                {
+                    return rec;
+                }
+            }
+
+            auto * rec = new (std::nothrow) record();
+            if (!rec)
+            {
+                return nullptr;
+            }
+            auto * head = head_.load();
+            do
+            {
+                rec->next_ = head;
+            } while (!head_.compare_exchange_weak(head, rec));
+            return rec;
+        }
+
+        void release_record(
+            record * p_record)
+            noexcept
+        {
+            assert(p_record->nesting_ == 0);
+            p_record->epoch_.store(0, std::memory_order_release);
+
+            try_advance();
+            collect(p_record);
+            if (!p_record->retired_.empty())
+            {
+                // Out of memory, the record keeps them for its next owner.
+                std::lock_guard<std::mutex> l(orphans_mtx_);
+                try
+                {
+                    orphans_.insert(
+                        orphans_.end(),
+                        p_record->retired_.begin(),
+                        p_record->retired_.end());
+                    p_record->retired_.clear();
+                }
+                catch (...)
+                {}
+            }
+            p_record->active_.store(false, std::memory_order_release);
+        }
+
+        /**
+        * \brief Advance the global epoch if every active reader observed it.
+        */
+        bool try_advance(
+            void)
+            noexcept
+        {
+            auto e = epoch_.load();
+            for (auto * rec = head_.load(); rec; rec = rec->next_)
+            {
+                auto announced = rec->epoch_.load();
+                if ((announced & 1U) && (announced >> 1U) != e)
+                {
+                    return false;
+                }
+            }
+            return epoch_.compare_exchange_strong(e, e + 1U) || epoch_.load() != e;
+        }
+
+        /**
+        * \brief Free expired pointers of target record in place.
+        * Pointers retired by the destructors run here are appended and wait for the next collect.
+        */
+        void collect(
+            record * p_record)
+            noexcept
+        {
+            if (p_record->collecting_)
+            {
+                return;
+            }
+
+            // Adopt pointers left behind by exited threads.
+            if (orphans_mtx_.try_lock())
+            {
+                try
+                {
+                    p_record->retired_.insert(
+                        p_record->retired_.end(),
+                        orphans_.begin(),
+                        orphans_.end());
+                    orphans_.clear();
+                }
+                catch (...)
+                {}
+                orphans_mtx_.unlock();
+            }
+
+            auto e = epoch_.load();
+            auto & list = p_record->retired_;
+            auto expired = static_cast<size_t>(std::partition(
+                list.begin(),
+                list.end(),
+                [e](retired const & r)
+                {
+                    return r.epoch_ + 2U <= e;
+                }) - list.begin());
+
+            p_record->collecting_ = true;
+            for (size_t i = 0; i < expired; ++i)
+            {
+                list[i].free_(list[i].ptr_);
+            }
+            p_record->collecting_ = false;
+            list.erase(list.begin(), list.begin() + expired);
+        }
+
+    }; // class epoch_domain
+
+
+    /**
+    * \class mem::epoch_guard
+    *
+    * \brief Read-side section scope.
+    * Pointers read from an epoch protected chain stay valid until the guard is destroyed.
+    */
+    class epoch_guard final
+    {
+
+    public:
+        epoch_guard(epoch_guard const &) = delete;
+        epoch_guard(epoch_guard &&) = delete;
+        void operator=(epoch_guard const &) = delete;
+        void operator=(epoch_guard &&) = delete;
+
+    public:
+        epoch_guard(
+            void)
+        {
+            epoch_domain::instance().enter();
+        }
+
+        ~epoch_guard(
+            void)
+            noexcept
+        {
+            epoch_domain::instance().leave();
+        }
+
+    }; // class epoch_guard
+
+
+    /**
+    * \brief Epoch based reclamation deleter used by smart pointer(s).
+    * Retires pointer to the current epoch, "delete" is called once every reader left it.
+    */
+    template<
+        class TType>
+    struct epoch_deleter
+    {
+        constexpr epoch_deleter(
+            void)
+            noexcept = default;
+
+        template<
+            class TType2,
+            class = typename std::enable_if<std::is_convertible<TType2 *, TType *>::value, void>::type>
+            epoch_deleter(epoch_deleter<TType2> const &)
+            noexcept
+        {}
+
+        void free(
+            TType * p_ptr)
+            const noexcept
+        {
+            static_assert(
+                0 < sizeof(TType),
+                "can't delete an incomplete type");
+            epoch_domain::instance().retire(p_ptr);
+        }
+
+    }; // struct epoch_deleter
+
+} // namespace mem
+
+#endif // __MEMORY_SYNC_PTR_EPOCH_H__
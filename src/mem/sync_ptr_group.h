@@ -0,0 +1,299 @@
+
+#ifndef __MEMORY_SYNC_PTR_GROUP_H__
+#define __MEMORY_SYNC_PTR_GROUP_H__
+
+#include <cassert>
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#ifndef __MEMORY_SYNC_PTR_H__
+#include "mem/sync_ptr.h"
+#endif
+
+
+namespace mem
+{
+
+    /**
+    * \class mem::sync_group
+    *
+    * \brief Transactional update of several sync_ptr chains.
+    * stage() records a new pointer for a chain, commit() publishes every staged pointer at once:
+    * pointer holders of all staged chains are locked in address order, pointers are set,
+    * holders are unlocked and previous pointers are freed.
+    * snapshot() locks holders the same way, so it never reads a mix of previous and committed pointers.
+    *
+    * Chains may have different pointee types but need a lockable holder policy (ptr_holder_ts).
+    * A chain staged twice ends up with its last staged pointer.
+    * Pointers staged but not committed are freed with the group.
+    *
+    * \note Like get(), snapshot() pointers are only protected from later updates by the deleter policy.
+    */
+    class sync_group final
+    {
+
+    private:
+        /**
+        * \brief Type erased staged update.
+        */
+        class entry
+        {
+
+        public:
+            virtual ~entry(
+                void)
+            {}
+
+            virtual void const * key(
+                void)
+                const noexcept = 0;
+
+            virtual void lock(
+                void)
+                const noexcept = 0;
+
+            virtual void unlock(
+                void)
+                const noexcept = 0;
+
+            /**
+            * \brief Publish staged pointer, keep previous one.
+            */
+            virtual void publish(
+                void)
+                noexcept = 0;
+
+        }; // class entry
+
+        template<
+            class TSyncPtr>
+        class typed_entry final
+            : public entry
+        {
+
+        private:
+            typedef typename TSyncPtr::pointer_type pointer_t;
+
+        private:
+            TSyncPtr        chain_;
+            pointer_t *     ptr_;
+
+        public:
+            typed_entry(
+                TSyncPtr const & p_chain,
+                pointer_t * p_ptr)
+                noexcept
+                // Members.
+                : chain_(p_chain)
+                , ptr_(p_ptr)
+            {}
+
+            /**
+            * \brief Free staged pointer if never published, previous one otherwise.
+            */
+            ~typed_entry(
+                void)
+            {
+                chain_.body_->retire_ptr(ptr_);
+            }
+
+            void const * key(
+                void)
+                const noexcept override
+            {
+                return chain_.body_;
+            }
+
+            void lock(
+                void)
+                const noexcept override
+            {
+                chain_.body_->lock_ptr();
+            }
+
+            void unlock(
+                void)
+                const noexcept override
+            {
+                chain_.body_->unlock_ptr();
+            }
+
+            void publish(
+                void)
+                noexcept override
+            {
+                ptr_ = chain_.body_->swap_ptr(ptr_);
+            }
+
+        }; // class typed_entry
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        std::vector<std::unique_ptr<entry>>     entries_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        sync_group(sync_group const &) = delete;
+        void operator=(sync_group const &) = delete;
+
+    public:
+        sync_group(
+            void) = default;
+
+        sync_group(
+            sync_group &&) = default;
+
+        sync_group & operator=(
+            sync_group &&) = default;
+
+
+    public:
+        /**
+        * \brief Stage target pointer for target chain.
+        * The group takes ownership of the pointer and keeps the chain alive until commit.
+        */
+        template <
+            class TPtr,
+            template <class T> class TDeleter,
+            template <class T> class THolder,
+            class TRefCounter,
+            class TPtrCompatible>
+        void stage(
+            sync_ptr<TPtr, TDeleter, THolder, TRefCounter> const & p_chain,
+            TPtrCompatible * p_ptr)
+        {
+            typedef sync_ptr<TPtr, TDeleter, THolder, TRefCounter> sync_ptr_t;
+
+            assert(p_chain.body_);
+            std::unique_ptr<entry> e;
+            try
+            {
+                e.reset(new typed_entry<sync_ptr_t>(p_chain, p_ptr));
+                entries_.reserve(entries_.size() + 1U);
+            }
+            catch (...)
+            {
+                if (!e)
+                {
+                    p_chain.body_->retire_ptr(p_ptr);
+                }
+                throw;
+            }
+            entries_.push_back(std::move(e));
+        }
+
+        /**
+        * \brief Publish every staged pointer, free previous ones and clear the group.
+        */
+        void commit(
+            void)
+            noexcept
+        {
+            std::stable_sort(
+                entries_.begin(),
+                entries_.end(),
+                [](std::unique_ptr<entry> const & p_lhs, std::unique_ptr<entry> const & p_rhs)
+                {
+                    return std::less<void const *>()(p_lhs->key(), p_rhs->key());
+                });
+
+            for (auto & e : entries_)
+            {
+                e->lock();
+            }
+            for (auto & e : entries_)
+            {
+                e->publish();
+            }
+            for (auto it = entries_.rbegin(); it != entries_.rend(); ++it)
+            {
+                (*it)->unlock();
+            }
+
+            // Previous pointers are freed outside of the holder locks.
+            entries_.clear();
+        }
+
+        inline size_t size(
+            void)
+            const noexcept
+        {
+            return entries_.size();
+        }
+
+
+    public:
+        /**
+        * \brief Read pointers of target chains consistently with commit().
+        */
+        template<
+            class... TSyncPtr>
+        static std::tuple<typename TSyncPtr::pointer_type *...> snapshot(
+            TSyncPtr const &... p_chains)
+            noexcept
+        {
+            holder_lock locks[] = { holder_lock::of(p_chains)... };
+            std::sort(
+                std::begin(locks),
+                std::end(locks),
+                [](holder_lock const & p_lhs, holder_lock const & p_rhs)
+                {
+                    return std::less<void const *>()(p_lhs.body_, p_rhs.body_);
+                });
+
+            for (auto & l : locks)
+            {
+                l.lock_(l.body_);
+            }
+            auto ptrs = std::make_tuple(p_chains.get()...);
+            for (auto it = std::rbegin(locks); it != std::rend(locks); ++it)
+            {
+                it->unlock_(it->body_);
+            }
+            return ptrs;
+        }
+
+
+    private:
+        /**
+        * \brief Holder lock of one chain, see snapshot().
+        */
+        struct holder_lock
+        {
+            void const *    body_;
+            void            (*lock_)(void const *);
+            void            (*unlock_)(void const *);
+
+            template<
+                class TSyncPtr>
+            static holder_lock of(
+                TSyncPtr const & p_chain)
+                noexcept
+            {
+                typedef typename TSyncPtr::body_t body_t;
+
+                assert(p_chain.body_);
+                return holder_lock{
+                    p_chain.body_,
+                    [](void const * p_body) { static_cast<body_t const *>(p_body)->lock_ptr(); },
+                    [](void const * p_body) { static_cast<body_t const *>(p_body)->unlock_ptr(); } };
+            }
+        };
+
+    }; // class sync_group
+
+} // namespace mem
+
+#endif // __MEMORY_SYNC_PTR_GROUP_H__
@@ -0,0 +1,383 @@
+
+#ifndef __MEMORY_SYNC_PTR_INTRUSIVE_H__
+#define __MEMORY_SYNC_PTR_INTRUSIVE_H__
+
+#include <cassert>
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#ifndef __MEMORY_SYNC_PTR_POLICY_H__
+#include "mem/sync_ptr_policy.h"
+#endif
+
+
+namespace mem
+{
+
+    template <
+        class TPtr,
+        template <class T> class TDeleter>
+    class intrusive_sync_ptr;
+
+
+    /**
+    * \class mem::intrusive_sync_base
+    *
+    * \brief Chain state embedded in the pointee of intrusive_sync_ptr.
+    * Derive from it, or hold it as a member and specialize intrusive_sync_hook.
+    * Copying or assigning the pointee doesn't copy the chain state.
+    */
+    template<
+        class TPtr>
+    class intrusive_sync_base
+    {
+
+        template <
+            class TPtr2,
+            template <class T> class TDeleter>
+        friend class intrusive_sync_ptr;
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        std::atomic<size_t>     ref_count_;
+        // Current pointee of the chain rooted here, this object itself until the first reset().
+        std::atomic<TPtr *>     ptr_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        intrusive_sync_base(
+            void)
+            noexcept
+            // Members.
+            : ref_count_(0)
+            , ptr_(nullptr)
+        {}
+
+        intrusive_sync_base(
+            intrusive_sync_base const &)
+            noexcept
+            // Members.
+            : ref_count_(0)
+            , ptr_(nullptr)
+        {}
+
+        intrusive_sync_base & operator=(
+            intrusive_sync_base const &)
+            noexcept
+        {
+            return *this;
+        }
+
+    }; // class intrusive_sync_base
+
+
+    /**
+    * \brief Hook to the chain state of a pointee, the intrusive_sync_base it derives from by default.
+    * Specialize it for types holding the state as a member.
+    */
+    template<
+        class TPtr>
+    struct intrusive_sync_hook
+    {
+        static inline intrusive_sync_base<TPtr> & state(
+            TPtr * p_ptr)
+            noexcept
+        {
+            return *p_ptr;
+        }
+
+    }; // struct intrusive_sync_hook
+
+
+    /**
+    * \class mem::intrusive_sync_ptr
+    *
+    * \brief Synchronized pointer keeping its chain state in the pointee, one pointer wide.
+    * The first pointee of a chain is its root: it holds the reference count and the current pointee,
+    * so a chain that was never reset needs no allocation besides the pointee and
+    * get() reads the pointee's own cache line.
+    *
+    * reset() redirects the root to the new pointee, every copy follows.
+    * The root object stays allocated, and is only destroyed, when the last copy goes away,
+    * later pointees are freed as soon as they are replaced.
+    * Unlike sync_ptr, release() and exchange() aren't offered, the root can't leave its chain.
+    *
+    * \note Raw pointers must be fresh objects: a pointee published by reset() can't root another chain.
+    * Like sync_ptr, returned pointers are only protected from concurrent resets by the deleter policy.
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter = default_deleter>
+    class intrusive_sync_ptr final
+    {
+
+    public:
+        typedef TPtr                    pointer_type;
+        typedef TDeleter<TPtr>          deleter_type;
+        typedef intrusive_sync_hook<TPtr> hook_type;
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        TPtr *      root_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        intrusive_sync_ptr(
+            void)
+            noexcept
+            // Members.
+            : root_(nullptr)
+        {}
+
+        /**
+        * \brief Start a chain rooted at target fresh pointer.
+        */
+        explicit intrusive_sync_ptr(
+            TPtr * p_ptr)
+            noexcept
+            // Members.
+            : root_(nullptr)
+        {
+            if (p_ptr)
+            {
+                adopt(p_ptr);
+            }
+        }
+
+        intrusive_sync_ptr(
+            intrusive_sync_ptr const & p_other)
+            noexcept
+            // Members.
+            : root_(p_other.root_)
+        {
+            if (root_)
+            {
+                hook_type::state(root_).ref_count_.fetch_add(1U, std::memory_order_relaxed);
+            }
+        }
+
+        intrusive_sync_ptr(
+            intrusive_sync_ptr && p_other)
+            noexcept
+            // Members.
+            : root_(p_other.root_)
+        {
+            p_other.root_ = nullptr;
+        }
+
+        ~intrusive_sync_ptr(
+            void)
+            noexcept
+        {
+            leave();
+        }
+
+
+    public:
+        intrusive_sync_ptr & operator=(
+            intrusive_sync_ptr const & p_other)
+            noexcept
+        {
+            intrusive_sync_ptr(p_other).swap(*this);
+            return *this;
+        }
+
+        intrusive_sync_ptr & operator=(
+            intrusive_sync_ptr && p_other)
+            noexcept
+        {
+            intrusive_sync_ptr(std::move(p_other)).swap(*this);
+            return *this;
+        }
+
+        inline void swap(
+            intrusive_sync_ptr & p_other)
+            noexcept
+        {
+            std::swap(root_, p_other.root_);
+        }
+
+
+    public:
+        /**
+        * \brief Redirect the chain to target pointer and free the replaced one unless it is the root.
+        * An empty intrusive_sync_ptr starts a chain rooted at target pointer.
+        */
+        void reset(
+            TPtr * p_ptr)
+            noexcept
+        {
+            if (!root_)
+            {
+                if (p_ptr)
+                {
+                    adopt(p_ptr);
+                }
+                return;
+            }
+            assert(p_ptr != get() && "Pointer is already the chain pointee.");
+            dispose(hook_type::state(root_).ptr_.exchange(p_ptr, std::memory_order_acq_rel));
+        }
+
+        /**
+        * \brief Clear the pointee of the chain, copies keep the chain.
+        */
+        inline void reset(
+            void)
+            noexcept
+        {
+            if (root_)
+            {
+                dispose(hook_type::state(root_).ptr_.exchange(nullptr, std::memory_order_acq_rel));
+            }
+        }
+
+
+    public:
+        inline TPtr * get(
+            void)
+            const noexcept
+        {
+            return root_ ? hook_type::state(root_).ptr_.load(std::memory_order_acquire) : nullptr;
+        }
+
+        inline TPtr & operator*(
+            void)
+            const noexcept
+        {
+            return *get();
+        }
+
+        inline TPtr * operator->(
+            void)
+            const noexcept
+        {
+            return get();
+        }
+
+        /**
+        * \brief Number of intrusive_sync_ptr in the chain.
+        */
+        inline size_t count(
+            void)
+            const noexcept
+        {
+            return root_ ? hook_type::state(root_).ref_count_.load(std::memory_order_relaxed) : 0;
+        }
+
+
+    public:
+        inline bool valid(
+            void)
+            const noexcept
+        {
+            return (get() != nullptr);
+        }
+
+        inline operator bool(
+            void)
+            const noexcept
+        {
+            return valid();
+        }
+
+
+    private:
+        inline void adopt(
+            TPtr * p_ptr)
+            noexcept
+        {
+            auto & state = hook_type::state(p_ptr);
+            assert(state.ref_count_.load(std::memory_order_relaxed) == 0 &&
+                "Pointer already roots a chain.");
+            state.ref_count_.store(1U, std::memory_order_relaxed);
+            state.ptr_.store(p_ptr, std::memory_order_release);
+            root_ = p_ptr;
+        }
+
+        /**
+        * \brief Free a replaced pointee, the root lives as long as the chain.
+        */
+        inline void dispose(
+            TPtr * p_ptr)
+            const noexcept
+        {
+            if (p_ptr && p_ptr != root_)
+            {
+                deleter_type().free(p_ptr);
+            }
+        }
+
+        inline void leave(
+            void)
+            noexcept
+        {
+            if (root_ &&
+                hook_type::state(root_).ref_count_.fetch_sub(1U, std::memory_order_acq_rel) == 1U)
+            {
+                dispose(hook_type::state(root_).ptr_.load(std::memory_order_acquire));
+                deleter_type().free(root_);
+            }
+            root_ = nullptr;
+        }
+
+    }; // class intrusive_sync_ptr
+
+
+    template <
+        class TPtr,
+        template <class T> class TDeleter = default_deleter,
+        class... TArgs>
+    inline intrusive_sync_ptr<TPtr, TDeleter> make_intrusive_sync(
+        TArgs&&... p_args)
+    {
+        return (intrusive_sync_ptr<TPtr, TDeleter>(new TPtr(std::forward<TArgs>(p_args)...)));
+    }
+
+
+    template <
+        class TPtr1,
+        template <class T> class TDeleter1,
+        class TPtr2,
+        template <class T> class TDeleter2>
+    inline bool operator==(
+        intrusive_sync_ptr<TPtr1, TDeleter1> const & p_lhs,
+        intrusive_sync_ptr<TPtr2, TDeleter2> const & p_rhs)
+        noexcept
+    {
+        return (p_lhs.get() == p_rhs.get());
+    }
+
+    template <
+        class TPtr1,
+        template <class T> class TDeleter1,
+        class TPtr2,
+        template <class T> class TDeleter2>
+    inline bool operator!=(
+        intrusive_sync_ptr<TPtr1, TDeleter1> const & p_lhs,
+        intrusive_sync_ptr<TPtr2, TDeleter2> const & p_rhs)
+        noexcept
+    {
+        return !(p_lhs == p_rhs);
+    }
+
+} // namespace mem
+
+#endif // __MEMORY_SYNC_PTR_INTRUSIVE_H__
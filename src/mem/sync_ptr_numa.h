@@ -0,0 +1,532 @@
+
+#ifndef __MEMORY_SYNC_PTR_NUMA_H__
+#define __MEMORY_SYNC_PTR_NUMA_H__
+
+#include <cassert>
+#include <cstddef>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#ifndef __MEMORY_SYNC_PTR_H__
+#include "mem/sync_ptr.h"
+#endif
+
+#ifndef __MEMORY_SYNC_PTR_RCU_H__
+#include "mem/sync_ptr_rcu.h"
+#endif
+
+
+namespace mem
+{
+
+    /**
+    * \class mem::numa_topology
+    *
+    * \brief NUMA nodes and their cpus, read once from /sys/devices/system/node.
+    * Nodes are numbered densely from 0 in /sys order.
+    * A single node holding every cpu is assumed when /sys can't be read or on other systems.
+    */
+    class numa_topology final
+    {
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        std::vector<std::vector<int>>   cpus_;
+        std::vector<size_t>             node_of_cpu_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        numa_topology(numa_topology const &) = delete;
+        numa_topology(numa_topology &&) = delete;
+        void operator=(numa_topology const &) = delete;
+        void operator=(numa_topology &&) = delete;
+
+    private:
+        numa_topology(
+            void)
+        {
+            std::string online;
+            std::ifstream in("/sys/devices/system/node/online");
+            if (std::getline(in, online))
+            {
+                for (auto node : parse_cpulist(online))
+                {
+                    std::string list;
+                    std::ifstream node_in(
+                        "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+                    if (std::getline(node_in, list))
+                    {
+                        auto cpus = parse_cpulist(list);
+                        // Memory only nodes have no cpu to read from.
+                        if (!cpus.empty())
+                        {
+                            cpus_.push_back(std::move(cpus));
+                        }
+                    }
+                }
+            }
+
+            if (cpus_.size() < 2U)
+            {
+                cpus_.clear();
+                return;
+            }
+            for (size_t n = 0; n < cpus_.size(); ++n)
+            {
+                for (auto cpu : cpus_[n])
+                {
+                    if (node_of_cpu_.size() <= static_cast<size_t>(cpu))
+                    {
+                        node_of_cpu_.resize(static_cast<size_t>(cpu) + 1U, 0);
+                    }
+                    node_of_cpu_[static_cast<size_t>(cpu)] = n;
+                }
+            }
+        }
+
+    public:
+        static numa_topology const & instance(
+            void)
+        {
+            static numa_topology topology;
+            return topology;
+        }
+
+
+    public:
+        inline size_t node_count(
+            void)
+            const noexcept
+        {
+            return cpus_.empty() ? 1U : cpus_.size();
+        }
+
+        /**
+        * \brief Cpus of target node, empty on single node systems.
+        */
+        inline std::vector<int> const & cpus(
+            size_t p_node)
+            const noexcept
+        {
+            static std::vector<int> const none;
+            return p_node < cpus_.size() ? cpus_[p_node] : none;
+        }
+
+        /**
+        * \brief Node of the cpu the calling thread runs on.
+        */
+        inline size_t current_node(
+            void)
+            const noexcept
+        {
+#if defined(__linux__)
+            if (!node_of_cpu_.empty())
+            {
+                auto cpu = ::sched_getcpu();
+                if (cpu >= 0 && static_cast<size_t>(cpu) < node_of_cpu_.size())
+                {
+                    return node_of_cpu_[static_cast<size_t>(cpu)];
+                }
+            }
+#endif
+            return 0;
+        }
+
+
+    public:
+        /**
+        * \brief Parse a /sys cpu or node list such as "0-3,8,10-11".
+        */
+        static std::vector<int> parse_cpulist(
+            std::string const & p_list)
+        {
+            std::vector<int> ids;
+            std::istringstream in(p_list);
+            std::string range;
+            while (std::getline(in, range, ','))
+            {
+                int first = 0;
+                int last = 0;
+                char dash = 0;
+                std::istringstream range_in(range);
+                if (!(range_in >> first))
+                {
+                    continue;
+                }
+                last = first;
+                if (range_in >> dash && dash == '-')
+                {
+                    range_in >> last;
+                }
+                for (int id = first; id <= last; ++id)
+                {
+                    ids.push_back(id);
+                }
+            }
+            return ids;
+        }
+
+    }; // class numa_topology
+
+
+    /**
+    * \class mem::numa_node_scope
+    *
+    * \brief Run the calling thread on the cpus of target node for the scope lifetime.
+    * Memory first touched in the scope is then allocated on that node under the default Linux policy.
+    * Does nothing on single node systems.
+    */
+    class numa_node_scope final
+    {
+
+    private:
+#if defined(__linux__)
+        cpu_set_t   previous_;
+#endif
+        bool        bound_;
+
+    public:
+        numa_node_scope(numa_node_scope const &) = delete;
+        numa_node_scope(numa_node_scope &&) = delete;
+        void operator=(numa_node_scope const &) = delete;
+        void operator=(numa_node_scope &&) = delete;
+
+    public:
+        explicit numa_node_scope(
+            size_t p_node)
+            noexcept
+            // Members.
+            : bound_(false)
+        {
+#if defined(__linux__)
+            auto const & cpus = numa_topology::instance().cpus(p_node);
+            if (!cpus.empty() &&
+                ::sched_getaffinity(0, sizeof(previous_), &previous_) == 0)
+            {
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                for (auto cpu : cpus)
+                {
+                    if (cpu < CPU_SETSIZE)
+                    {
+                        CPU_SET(cpu, &set);
+                    }
+                }
+                bound_ = (::sched_setaffinity(0, sizeof(set), &set) == 0);
+            }
+#else
+            (void)p_node;
+#endif
+        }
+
+        ~numa_node_scope(
+            void)
+        {
+#if defined(__linux__)
+            if (bound_)
+            {
+                ::sched_setaffinity(0, sizeof(previous_), &previous_);
+            }
+#endif
+        }
+
+    }; // class numa_node_scope
+
+
+    /**
+    * \class mem::numa_sync_ptr
+    *
+    * \brief Read-mostly sync_ptr chain keeping one pointee replica per NUMA node.
+    * reset() clones the pointee (emplace() constructs it) once per node, each replica is built
+    * while the calling thread runs on its node so its memory is node local.
+    * get() returns the replica of the node the calling thread runs on.
+    * Copies share the chain, a reset replaces every replica at once.
+    *
+    * Replicas are independent objects: pointees must be treated as read-only,
+    * in place updates only reach the replica they are made on.
+    * Single node systems keep one replica and get() does not look up the node.
+    *
+    * The replica set is held by THolder, whose get() runs on every dereference: it must not take a lock,
+    * a shared lock word written by every socket costs more than the remote read replication avoids.
+    * The default RCU holder reads with a plain load and waits for readers inside an rcu_read_guard on reset.
+    *
+    * \note Replicas read outside an rcu_read_guard are only protected from concurrent updates
+    * by the deleter policy, which frees the whole replica set at once.
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class THolder = ptr_holder_rcu>
+    class numa_sync_ptr final
+    {
+
+    public:
+        typedef TPtr pointer_type;
+
+    private:
+        /**
+        * \brief One replica per node, freed together.
+        */
+        class replica_set final
+        {
+
+        private:
+            std::vector<TPtr *>     replicas_;
+
+        public:
+            replica_set(replica_set const &) = delete;
+            void operator=(replica_set const &) = delete;
+
+        public:
+            replica_set(
+                void)
+                noexcept = default;
+
+            ~replica_set(
+                void)
+            {
+                for (auto * p : replicas_)
+                {
+                    delete p;
+                }
+            }
+
+            /**
+            * \brief Allocate target number of empty replica slots.
+            */
+            inline void resize(
+                size_t p_count)
+            {
+                replicas_.resize(p_count, nullptr);
+            }
+
+            inline void set_replica(
+                size_t p_node,
+                TPtr * p_ptr)
+                noexcept
+            {
+                replicas_[p_node] = p_ptr;
+            }
+
+            inline TPtr * at(
+                size_t p_node)
+                const noexcept
+            {
+                return replicas_[p_node < replicas_.size() ? p_node : 0];
+            }
+
+            inline size_t size(
+                void)
+                const noexcept
+            {
+                return replicas_.size();
+            }
+
+        }; // class replica_set
+
+        typedef sync_ptr<replica_set, TDeleter, THolder> chain_t;
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        chain_t     chain_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        numa_sync_ptr(
+            void) = default;
+
+        /**
+        * \brief Replicate target pointer, which becomes the replica of the calling thread node.
+        */
+        explicit numa_sync_ptr(
+            TPtr * p_ptr)
+            : chain_(replicate(p_ptr))
+        {}
+
+        numa_sync_ptr(
+            numa_sync_ptr const &) = default;
+
+        numa_sync_ptr(
+            numa_sync_ptr &&) = default;
+
+        numa_sync_ptr & operator=(
+            numa_sync_ptr const &) = default;
+
+        numa_sync_ptr & operator=(
+            numa_sync_ptr &&) = default;
+
+
+    public:
+        /**
+        * \brief Replace every replica by a clone of target pointer.
+        * Target pointer becomes the replica of the calling thread node.
+        */
+        void reset(
+            TPtr * p_ptr)
+        {
+            assert(p_ptr);
+            chain_.reset(replicate(p_ptr));
+        }
+
+        /**
+        * \brief Replace every replica by one constructed from target arguments on its node.
+        */
+        template<
+            class... TArgs>
+        void emplace(
+            TArgs const &... p_args)
+        {
+            auto const & topology = numa_topology::instance();
+            std::unique_ptr<replica_set> replicas(new replica_set());
+            replicas->resize(topology.node_count());
+            for (size_t n = 0; n < topology.node_count(); ++n)
+            {
+                numa_node_scope scope(n);
+                replicas->set_replica(n, new TPtr(p_args...));
+            }
+            chain_.reset(replicas.release());
+        }
+
+        inline void reset(
+            void)
+            noexcept
+        {
+            chain_.reset();
+        }
+
+
+    public:
+        /**
+        * \brief Replica of the calling thread node.
+        */
+        inline TPtr * get(
+            void)
+            const noexcept
+        {
+            auto * replicas = chain_.get();
+            if (!replicas)
+            {
+                return nullptr;
+            }
+            return replicas->size() == 1U ?
+                replicas->at(0) :
+                replicas->at(numa_topology::instance().current_node());
+        }
+
+        /**
+        * \brief Replica of target node.
+        */
+        inline TPtr * get(
+            size_t p_node)
+            const noexcept
+        {
+            auto * replicas = chain_.get();
+            return replicas ? replicas->at(p_node) : nullptr;
+        }
+
+        inline TPtr & operator*(
+            void)
+            const noexcept
+        {
+            return *get();
+        }
+
+        inline TPtr * operator->(
+            void)
+            const noexcept
+        {
+            return get();
+        }
+
+        inline size_t replicas(
+            void)
+            const noexcept
+        {
+            auto * replicas = chain_.get();
+            return replicas ? replicas->size() : 0;
+        }
+
+        inline size_t count(
+            void)
+            const noexcept
+        {
+            return chain_.count();
+        }
+
+        inline size_t version(
+            std::memory_order p_order = std::memory_order_acquire)
+            const noexcept
+        {
+            return chain_.version(p_order);
+        }
+
+
+    public:
+        inline bool valid(
+            void)
+            const noexcept
+        {
+            return chain_.valid();
+        }
+
+        inline operator bool(
+            void)
+            const noexcept
+        {
+            return valid();
+        }
+
+
+    private:
+        /**
+        * \brief Build a replica set around target pointer.
+        */
+        static replica_set * replicate(
+            TPtr * p_ptr)
+        {
+            std::unique_ptr<TPtr> ptr(p_ptr);
+            auto const & topology = numa_topology::instance();
+            auto local = topology.current_node();
+
+            std::unique_ptr<replica_set> replicas(new replica_set());
+            replicas->resize(topology.node_count());
+            for (size_t n = 0; n < topology.node_count(); ++n)
+            {
+                if (n != local)
+                {
+                    numa_node_scope scope(n);
+                    replicas->set_replica(n, new TPtr(*ptr));
+                }
+            }
+            replicas->set_replica(local, ptr.release());
+            return replicas.release();
+        }
+
+    }; // class numa_sync_ptr
+
+} // namespace mem
+
+#endif // __MEMORY_SYNC_PTR_NUMA_H__
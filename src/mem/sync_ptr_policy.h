@@ -4,13 +4,31 @@
 
 #include <cassert>
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <thread>
+#include <type_traits>
+
+// Memory resource overloads need C++17 <memory_resource>.
+#if defined(__has_include)
+#if __has_include(<memory_resource>) && (__cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L))
+#include <memory_resource>
+#define SYNC_PTR_PMR 1
+#endif
+#endif
 
 
 namespace mem
 {
+
+    /**
+    * \brief Cache line size used to pad shared state apart.
+    */
+    constexpr size_t cache_line_size = 64U;
+
         
     /** 
     * \brief Default allocator used by smart pointer(s).
@@ -45,6 +63,21 @@ namespace mem
     }; // struct default_allocator
 
 
+    /**
+    * \brief Tag selecting single allocation construction.
+    * Pointee shares its allocation with the smart pointer control block.
+    */
+    struct inplace_t
+    {
+        explicit constexpr inplace_t(
+            void)
+            noexcept = default;
+
+    }; // struct inplace_t
+
+    constexpr inplace_t inplace{};
+
+
     /**
     * \brief Default deleter used by smart pointer(s).
     * Calls "delete" on target template type pointer.
@@ -102,6 +135,176 @@ namespace mem
 
     }; // struct noop_deleter
 
+    /**
+    * \brief True if target deleter policy is done with a pointer when free() returns.
+    * In place pointees (see make_sync_inplace) require it: their slot lives in the chain block
+    * and can't be retired past it. Specialize it for custom deleters freeing synchronously.
+    */
+    template<
+        class TDeleter>
+    struct is_immediate_deleter
+        : std::false_type
+    {};
+
+    template<
+        class TType>
+    struct is_immediate_deleter<default_deleter<TType>>
+        : std::true_type
+    {};
+
+    template<
+        class TType>
+    struct is_immediate_deleter<noop_deleter<TType>>
+        : std::true_type
+    {};
+
+    /**
+    * \brief Heap array carrying its element count, pointee of sync_ptr<T[]>.
+    * Count and elements share one allocation, the count is stored right before the first element
+    * so size() always matches the array the pointer was read from.
+    * sync_ptr<T[]> pointees must come from create() or create_for_overwrite().
+    */
+    template<
+        class TType>
+    struct array_block
+    {
+        typedef TType (*pointer)[];
+
+        static_assert(
+            alignof(TType) <= alignof(std::max_align_t),
+            "Over-aligned types can't be stored in an array block.");
+
+        /**
+        * \brief Allocate target number of value-initialized elements.
+        */
+        static pointer create(
+            size_t p_size)
+        {
+            return construct(p_size, std::true_type());
+        }
+
+        /**
+        * \brief Allocate target number of default-initialized elements,
+        * trivial types are left uninitialized to be overwritten.
+        */
+        static pointer create_for_overwrite(
+            size_t p_size)
+        {
+            return construct(p_size, std::false_type());
+        }
+
+        static inline size_t size(
+            pointer p_ptr)
+            noexcept
+        {
+            return p_ptr ? *header(p_ptr) : 0;
+        }
+
+        /**
+        * \brief Destroy elements in reverse order and free the block.
+        */
+        static void destroy(
+            pointer p_ptr)
+            noexcept
+        {
+            if (!p_ptr)
+            {
+                return;
+            }
+            auto * first = *p_ptr;
+            for (auto i = size(p_ptr); i > 0; --i)
+            {
+                first[i - 1U].~TType();
+            }
+            ::operator delete(header(p_ptr));
+        }
+
+    private:
+        static constexpr size_t header_size(
+            void)
+            noexcept
+        {
+            return (sizeof(size_t) + alignof(TType) - 1U) & ~(alignof(TType) - 1U);
+        }
+
+        static inline size_t * header(
+            pointer p_ptr)
+            noexcept
+        {
+            return reinterpret_cast<size_t *>(reinterpret_cast<char *>(p_ptr) - header_size());
+        }
+
+        template<
+            class TValueInit>
+        static pointer construct(
+            size_t p_size,
+            TValueInit)
+        {
+            if (p_size > (static_cast<size_t>(-1) - header_size()) / sizeof(TType))
+            {
+                throw std::bad_array_new_length();
+            }
+
+            auto * mem = static_cast<char *>(::operator new(header_size() + p_size * sizeof(TType)));
+            auto * first = reinterpret_cast<TType *>(mem + header_size());
+            size_t i = 0;
+            try
+            {
+                for (; i < p_size; ++i)
+                {
+                    construct_at(first + i, TValueInit());
+                }
+            }
+            catch (...)
+            {
+                while (i > 0)
+                {
+                    first[--i].~TType();
+                }
+                ::operator delete(mem);
+                throw;
+            }
+            ::new (mem) size_t(p_size);
+            return reinterpret_cast<pointer>(first);
+        }
+
+        static inline void construct_at(
+            TType * p_ptr,
+            std::true_type)
+        {
+            ::new (static_cast<void *>(p_ptr)) TType();
+        }
+
+        static inline void construct_at(
+            TType * p_ptr,
+            std::false_type)
+        {
+            ::new (static_cast<void *>(p_ptr)) TType;
+        }
+
+    }; // struct array_block
+
+    /**
+    * \brief Default deleter of array pointees.
+    * Frees array blocks, destroying every element.
+    */
+    template<
+        class TType>
+    struct default_deleter<TType[]>
+    {
+        constexpr default_deleter(
+            void)
+            noexcept = default;
+
+        void free(
+            TType (*p_ptr)[])
+            const noexcept
+        {
+            array_block<TType>::destroy(p_ptr);
+        }
+
+    }; // struct default_deleter
+
 
 
     /**
@@ -154,6 +357,21 @@ namespace mem
             return ret;
         }
 
+        /**
+        * \brief Increment pointer count unless it already dropped to zero.
+        */
+        inline bool try_increment_ptr(
+            void)
+            noexcept
+        {
+            if (ref_count_ptr_ == 0)
+            {
+                return false;
+            }
+            ref_count_ptr_++;
+            return true;
+        }
+
         inline size_t count(
             void)
             const noexcept
@@ -172,6 +390,7 @@ namespace mem
 
     /**
     * \brief Atomic reference counter.
+    * Increments are relaxed, decrements acq_rel and loads acquire.
     */
     class atomic_ref_counter
     {
@@ -192,46 +411,295 @@ namespace mem
             void)
             noexcept
         {
-            ref_count_.fetch_add(1U);
+            ref_count_.fetch_add(1U, std::memory_order_relaxed);
         }
 
         inline size_t decrement(
             void)
             noexcept
         {
-            return ref_count_.fetch_sub(1U);
+            return ref_count_.fetch_sub(1U, std::memory_order_acq_rel);
         }
 
         inline void increment_ptr(
             void)
             noexcept
         {
-            ref_count_ptr_.fetch_add(1U);
+            ref_count_ptr_.fetch_add(1U, std::memory_order_relaxed);
         }
 
         inline size_t decrement_ptr(
             void)
             noexcept
         {
-            return ref_count_ptr_.fetch_sub(1U);
+            return ref_count_ptr_.fetch_sub(1U, std::memory_order_acq_rel);
+        }
+
+        /**
+        * \brief Increment pointer count unless it already dropped to zero.
+        */
+        inline bool try_increment_ptr(
+            void)
+            noexcept
+        {
+            auto n = ref_count_ptr_.load(std::memory_order_relaxed);
+            while (n > 0)
+            {
+                if (ref_count_ptr_.compare_exchange_weak(
+                    n,
+                    n + 1U,
+                    std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+            return false;
         }
 
         inline size_t count(
             void)
             const noexcept
         {
-            return ref_count_.load();
+            return ref_count_.load(std::memory_order_acquire);
         }
 
         inline size_t count_ptr(
             void)
             const noexcept
         {
-            return ref_count_ptr_.load();
+            return ref_count_ptr_.load(std::memory_order_acquire);
         }
 
     }; // class atomic_ref_counter
 
+    /**
+    * \brief Padded atomic reference counter.
+    * Each count sits on its own cache line, apart from the holder pointer preceding it.
+    * Increments are relaxed, decrements acq_rel and loads acquire.
+    */
+    class padded_atomic_ref_counter
+    {
+
+    private:
+        char                        pad0_[cache_line_size];
+        std::atomic<size_t>	        ref_count_;
+        char                        pad1_[cache_line_size];
+        std::atomic<size_t>	        ref_count_ptr_;
+        char                        pad2_[cache_line_size];
+
+    public:
+        inline padded_atomic_ref_counter(
+            void)
+            noexcept
+            : ref_count_(1U)
+            , ref_count_ptr_(0)
+        {}
+
+        inline void increment(
+            void)
+            noexcept
+        {
+            ref_count_.fetch_add(1U, std::memory_order_relaxed);
+        }
+
+        inline size_t decrement(
+            void)
+            noexcept
+        {
+            return ref_count_.fetch_sub(1U, std::memory_order_acq_rel);
+        }
+
+        inline void increment_ptr(
+            void)
+            noexcept
+        {
+            ref_count_ptr_.fetch_add(1U, std::memory_order_relaxed);
+        }
+
+        inline size_t decrement_ptr(
+            void)
+            noexcept
+        {
+            return ref_count_ptr_.fetch_sub(1U, std::memory_order_acq_rel);
+        }
+
+        /**
+        * \brief Increment pointer count unless it already dropped to zero.
+        */
+        inline bool try_increment_ptr(
+            void)
+            noexcept
+        {
+            auto n = ref_count_ptr_.load(std::memory_order_relaxed);
+            while (n > 0)
+            {
+                if (ref_count_ptr_.compare_exchange_weak(
+                    n,
+                    n + 1U,
+                    std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        inline size_t count(
+            void)
+            const noexcept
+        {
+            return ref_count_.load(std::memory_order_acquire);
+        }
+
+        inline size_t count_ptr(
+            void)
+            const noexcept
+        {
+            return ref_count_ptr_.load(std::memory_order_acquire);
+        }
+
+    }; // class padded_atomic_ref_counter
+
+    /**
+    * \brief Both counts of a reference counter, as read by one operation.
+    */
+    struct ref_counts
+    {
+        size_t      count_;
+        size_t      count_ptr_;
+
+    }; // struct ref_counts
+
+    /**
+    * \brief Atomic reference counter packing both counts in one 64 bits word, 32 bits each.
+    * increment_both() and decrement_both() count a sync_ptr copy with a single RMW,
+    * so the two counts never disagree and the counter is 8 bytes smaller.
+    */
+    class packed_ref_counter
+    {
+
+    private:
+        static constexpr std::uint64_t one = 1U;
+        static constexpr std::uint64_t one_ptr = std::uint64_t(1U) << 32U;
+        static constexpr std::uint64_t half_mask = one_ptr - 1U;
+
+    private:
+        std::atomic<std::uint64_t>  word_;
+
+    public:
+        inline packed_ref_counter(
+            void)
+            noexcept
+            : word_(one)
+        {}
+
+        inline void increment(
+            void)
+            noexcept
+        {
+            auto w = word_.fetch_add(one, std::memory_order_relaxed);
+            assert((w & half_mask) != half_mask && "Reference count overflow.");
+            (void)w;
+        }
+
+        inline size_t decrement(
+            void)
+            noexcept
+        {
+            return static_cast<size_t>(word_.fetch_sub(one, std::memory_order_acq_rel) & half_mask);
+        }
+
+        inline void increment_ptr(
+            void)
+            noexcept
+        {
+            auto w = word_.fetch_add(one_ptr, std::memory_order_relaxed);
+            assert((w >> 32U) != half_mask && "Reference count overflow.");
+            (void)w;
+        }
+
+        inline size_t decrement_ptr(
+            void)
+            noexcept
+        {
+            return static_cast<size_t>(word_.fetch_sub(one_ptr, std::memory_order_acq_rel) >> 32U);
+        }
+
+        /**
+        * \brief Increment pointer count unless it already dropped to zero.
+        */
+        inline bool try_increment_ptr(
+            void)
+            noexcept
+        {
+            auto w = word_.load(std::memory_order_relaxed);
+            while ((w >> 32U) > 0)
+            {
+                if (word_.compare_exchange_weak(
+                    w,
+                    w + one_ptr,
+                    std::memory_order_relaxed))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+        * \brief Increment both counts with one fetch_add.
+        */
+        inline void increment_both(
+            void)
+            noexcept
+        {
+            auto w = word_.fetch_add(one | one_ptr, std::memory_order_relaxed);
+            assert((w & half_mask) != half_mask && "Reference count overflow.");
+            (void)w;
+        }
+
+        /**
+        * \brief Decrement both counts with one compare-exchange and return their previous values.
+        * Refused, with nothing changed, when the pointer count would drop to zero while other references remain:
+        * the pointer has to be released before the caller gives up its own reference (see sync_weak_ptr).
+        */
+        inline bool decrement_both(
+            ref_counts & p_previous)
+            noexcept
+        {
+            auto w = word_.load(std::memory_order_relaxed);
+            while ((w >> 32U) > 1U || ((w >> 32U) == 1U && (w & half_mask) == 1U))
+            {
+                if (word_.compare_exchange_weak(
+                    w,
+                    w - (one | one_ptr),
+                    std::memory_order_acq_rel,
+                    std::memory_order_relaxed))
+                {
+                    p_previous.count_ = static_cast<size_t>(w & half_mask);
+                    p_previous.count_ptr_ = static_cast<size_t>(w >> 32U);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        inline size_t count(
+            void)
+            const noexcept
+        {
+            return static_cast<size_t>(word_.load(std::memory_order_acquire) & half_mask);
+        }
+
+        inline size_t count_ptr(
+            void)
+            const noexcept
+        {
+            return static_cast<size_t>(word_.load(std::memory_order_acquire) >> 32U);
+        }
+
+    }; // class packed_ref_counter
+
 
 
     /**
@@ -319,6 +787,23 @@ namespace mem
             return ptr_;
         }
 
+        /**
+        * \brief Lock holder, set() and get() stay available to the locking thread (see sync_group).
+        */
+        inline void lock(
+            void)
+            const noexcept
+        {
+            mtx_.lock();
+        }
+
+        inline void unlock(
+            void)
+            const noexcept
+        {
+            mtx_.unlock();
+        }
+
     }; // class ptr_holder_ts
 
 } // namespace mem
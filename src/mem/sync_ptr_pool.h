@@ -0,0 +1,498 @@
+
+#ifndef __MEMORY_SYNC_PTR_POOL_H__
+#define __MEMORY_SYNC_PTR_POOL_H__
+
+#include <cassert>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+
+namespace mem
+{
+
+    /**
+    * \brief Pool statistics.
+    * Hits are allocations served from a magazine, misses carved a new slab.
+    * Per-thread counts are published on magazine exchange and thread exit.
+    */
+    struct pool_stats
+    {
+        size_t      hits_;
+        size_t      misses_;
+        size_t      slabs_;
+
+        inline double hit_rate(
+            void)
+            const noexcept
+        {
+            auto total = hits_ + misses_;
+            return total ? static_cast<double>(hits_) / static_cast<double>(total) : 0.0;
+        }
+
+    }; // struct pool_stats
+
+
+    /**
+    * \class mem::body_pool
+    *
+    * \brief Lock-free slab pool for one object type.
+    * Threads allocate and free from two thread-local magazines.
+    * Full and empty magazines are exchanged through lock-free depots,
+    * new blocks are carved from slabs when the depot is dry.
+    * Blocks freed by another thread than the allocating one go to the freeing thread magazines.
+    * Once a thread's magazines are gone (thread_local destructors at thread exit),
+    * its allocations and frees go straight through the depots.
+    *
+    * \note Slabs are never given back, the pool keeps its peak footprint until process exit.
+    */
+    template<
+        class TType>
+    class body_pool final
+    {
+        static_assert(
+            alignof(TType) <= alignof(std::max_align_t),
+            "Over-aligned types can't be pooled.");
+
+    public:
+        /** \brief Blocks per magazine. */
+        static constexpr size_t magazine_size = 32U;
+
+        /** \brief Blocks carved per slab. */
+        static constexpr size_t slab_size = magazine_size;
+
+
+    private:
+        struct block
+        {
+            alignas(TType) char storage_[sizeof(TType)];
+        };
+
+        struct magazine
+        {
+            std::atomic<magazine *>     next_;
+            magazine *                  link_;
+            size_t                      count_;
+            void *      blocks_[magazine_size];
+        };
+
+        struct slab
+        {
+            slab *      next_;
+            block       blocks_[slab_size];
+        };
+
+        /**
+        * \brief Lock-free magazine stack, push and pop are one CAS.
+        * The head packs the top magazine with a pop count, like the packed cc::tagged_atomic word:
+        * 64 bits pointers keep their low 48 bits and a 16 bits count, 32 bits pointers a 32 bits one.
+        * A pop working on a stale head fails its CAS even if the same magazine is on top again (ABA),
+        * magazines are never freed so reading a stale next_ is safe.
+        */
+        class depot
+        {
+
+        private:
+            static constexpr unsigned tag_shift = sizeof(void *) == 8U ? 48U : 32U;
+            static constexpr std::uint64_t ptr_mask = (std::uint64_t(1U) << tag_shift) - 1U;
+
+        private:
+            std::atomic<std::uint64_t>      head_;
+
+        public:
+            depot(
+                void)
+                noexcept
+                : head_(0)
+            {}
+
+            void push(
+                magazine * p_magazine)
+                noexcept
+            {
+                auto head = head_.load(std::memory_order_relaxed);
+                do
+                {
+                    p_magazine->next_.store(unpack(head), std::memory_order_relaxed);
+                } while (!head_.compare_exchange_weak(
+                    head,
+                    pack(p_magazine, head),
+                    std::memory_order_release,
+                    std::memory_order_relaxed));
+            }
+
+            magazine * pop(
+                void)
+                noexcept
+            {
+                auto head = head_.load(std::memory_order_acquire);
+                for (;;)
+                {
+                    auto * first = unpack(head);
+                    if (!first)
+                    {
+                        return nullptr;
+                    }
+                    auto next = pack(
+                        first->next_.load(std::memory_order_relaxed),
+                        head + (std::uint64_t(1U) << tag_shift));
+                    if (head_.compare_exchange_weak(
+                        head,
+                        next,
+                        std::memory_order_acquire,
+                        std::memory_order_acquire))
+                    {
+                        return first;
+                    }
+                }
+            }
+
+        private:
+            /**
+            * \brief Pack target magazine with the pop count of target head.
+            */
+            static std::uint64_t pack(
+                magazine * p_magazine,
+                std::uint64_t p_head)
+                noexcept
+            {
+                auto ptr = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(p_magazine));
+                assert((ptr & ~ptr_mask) == 0 && "Pointer doesn't fit the packed depot head.");
+                return (p_head & ~ptr_mask) | ptr;
+            }
+
+            static magazine * unpack(
+                std::uint64_t p_head)
+                noexcept
+            {
+                return reinterpret_cast<magazine *>(static_cast<std::uintptr_t>(p_head & ptr_mask));
+            }
+
+        }; // class depot
+
+        /**
+        * \brief Thread magazines, handed back to the depots on thread exit.
+        * The cache is then marked dead, see local_cache().
+        */
+        struct local
+        {
+            body_pool &     pool_;
+            magazine *      loaded_;
+            magazine *      previous_;
+            size_t          hits_;
+            size_t          misses_;
+
+            explicit local(
+                body_pool & p_pool)
+                noexcept
+                : pool_(p_pool)
+                , loaded_(nullptr)
+                , previous_(nullptr)
+                , hits_(0)
+                , misses_(0)
+            {}
+
+            ~local(
+                void)
+            {
+                exited() = true;
+                pool_.give_back(loaded_);
+                loaded_ = nullptr;
+                pool_.give_back(previous_);
+                previous_ = nullptr;
+                pool_.publish(*this);
+            }
+        };
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        depot                   full_;
+        depot                   empty_;
+        std::atomic<slab *>         slabs_;
+        std::atomic<magazine *>     magazines_;
+        std::atomic<size_t>         slab_count_;
+        std::atomic<size_t>     hits_;
+        std::atomic<size_t>     misses_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        body_pool(body_pool const &) = delete;
+        body_pool(body_pool &&) = delete;
+        void operator=(body_pool const &) = delete;
+        void operator=(body_pool &&) = delete;
+
+    private:
+        body_pool(
+            void)
+            noexcept
+            : slabs_(nullptr)
+            , magazines_(nullptr)
+            , slab_count_(0)
+            , hits_(0)
+            , misses_(0)
+        {}
+
+    public:
+        /**
+        * \brief Pool instance, never destroyed so blocks outlive every static object.
+        */
+        static body_pool & instance(
+            void)
+        {
+            static body_pool * pool = new body_pool();
+            return *pool;
+        }
+
+
+    public:
+        void * allocate(
+            void)
+        {
+            auto * cache = local_cache();
+            if (!cache)
+            {
+                return allocate_shared();
+            }
+            auto & l = *cache;
+            if (!l.loaded_ || !l.loaded_->count_)
+            {
+                if (l.previous_ && l.previous_->count_)
+                {
+                    std::swap(l.loaded_, l.previous_);
+                }
+                else if (auto * full = full_.pop())
+                {
+                    give_back(l.previous_);
+                    l.previous_ = l.loaded_;
+                    l.loaded_ = full;
+                    publish(l);
+                }
+                else
+                {
+                    ++l.misses_;
+                    publish(l);
+                    return carve();
+                }
+            }
+            ++l.hits_;
+            return l.loaded_->blocks_[--l.loaded_->count_];
+        }
+
+        void deallocate(
+            void * p_ptr)
+            noexcept
+        {
+            auto * cache = local_cache();
+            if (!cache)
+            {
+                deallocate_shared(p_ptr);
+                return;
+            }
+            auto & l = *cache;
+            if (!l.loaded_ || l.loaded_->count_ == magazine_size)
+            {
+                if (l.previous_ && l.previous_->count_ < magazine_size)
+                {
+                    std::swap(l.loaded_, l.previous_);
+                }
+                else
+                {
+                    auto * m = empty_magazine();
+                    if (!m)
+                    {
+                        // No memory for a magazine, the block stays unused in its slab.
+                        return;
+                    }
+                    if (l.previous_)
+                    {
+                        full_.push(l.previous_);
+                    }
+                    l.previous_ = l.loaded_;
+                    l.loaded_ = m;
+                }
+            }
+            l.loaded_->blocks_[l.loaded_->count_++] = p_ptr;
+        }
+
+        /**
+        * \brief Return aggregated statistics.
+        * Counts of the calling thread are published first.
+        */
+        pool_stats stats(
+            void)
+        {
+            if (auto * cache = local_cache())
+            {
+                publish(*cache);
+            }
+            return pool_stats{
+                hits_.load(std::memory_order_relaxed),
+                misses_.load(std::memory_order_relaxed),
+                slab_count_.load(std::memory_order_relaxed) };
+        }
+
+
+    private:
+        /**
+        * \brief Return thread magazines, null once they were destroyed.
+        */
+        local * local_cache(
+            void)
+            noexcept
+        {
+            if (exited())
+            {
+                return nullptr;
+            }
+            static thread_local local l(*this);
+            return &l;
+        }
+
+        /**
+        * \brief Thread exit flag, trivially destructible so it outlives every thread_local object.
+        */
+        static bool & exited(
+            void)
+            noexcept
+        {
+            static thread_local bool exited = false;
+            return exited;
+        }
+
+        /**
+        * \brief Allocate without thread magazines, from a depot magazine or a new slab.
+        */
+        void * allocate_shared(
+            void)
+        {
+            if (auto * m = full_.pop())
+            {
+                auto * p = m->blocks_[--m->count_];
+                give_back(m);
+                hits_.fetch_add(1U, std::memory_order_relaxed);
+                return p;
+            }
+            misses_.fetch_add(1U, std::memory_order_relaxed);
+            return carve();
+        }
+
+        /**
+        * \brief Free without thread magazines, into a depot magazine.
+        */
+        void deallocate_shared(
+            void * p_ptr)
+            noexcept
+        {
+            auto * m = full_.pop();
+            if (!m || m->count_ == magazine_size)
+            {
+                if (m)
+                {
+                    full_.push(m);
+                }
+                m = empty_magazine();
+                if (!m)
+                {
+                    // No memory for a magazine, the block stays unused in its slab.
+                    return;
+                }
+            }
+            m->blocks_[m->count_++] = p_ptr;
+            full_.push(m);
+        }
+
+        magazine * empty_magazine(
+            void)
+            noexcept
+        {
+            auto * m = empty_.pop();
+            if (!m)
+            {
+                m = new (std::nothrow) magazine();
+                if (m)
+                {
+                    // Every magazine stays linked here, depot heads hide them behind the pop count.
+                    auto * head = magazines_.load(std::memory_order_relaxed);
+                    do
+                    {
+                        m->link_ = head;
+                    } while (!magazines_.compare_exchange_weak(head, m, std::memory_order_relaxed));
+                }
+            }
+            if (m)
+            {
+                m->next_.store(nullptr, std::memory_order_relaxed);
+                m->count_ = 0;
+            }
+            return m;
+        }
+
+        void give_back(
+            magazine * p_magazine)
+            noexcept
+        {
+            if (p_magazine)
+            {
+                if (p_magazine->count_)
+                {
+                    full_.push(p_magazine);
+                }
+                else
+                {
+                    empty_.push(p_magazine);
+                }
+            }
+        }
+
+        void publish(
+            local & p_local)
+            noexcept
+        {
+            if (p_local.hits_)
+            {
+                hits_.fetch_add(p_local.hits_, std::memory_order_relaxed);
+                p_local.hits_ = 0;
+            }
+            if (p_local.misses_)
+            {
+                misses_.fetch_add(p_local.misses_, std::memory_order_relaxed);
+                p_local.misses_ = 0;
+            }
+        }
+
+        /**
+        * \brief Allocate a slab, return its first block and load the others.
+        */
+        void * carve(
+            void)
+        {
+            auto * s = static_cast<slab *>(::operator new(sizeof(slab)));
+            auto * head = slabs_.load(std::memory_order_relaxed);
+            do
+            {
+                s->next_ = head;
+            } while (!slabs_.compare_exchange_weak(head, s, std::memory_order_relaxed));
+            slab_count_.fetch_add(1U, std::memory_order_relaxed);
+
+            for (size_t i = 1; i < slab_size; ++i)
+            {
+                deallocate(&s->blocks_[i]);
+            }
+            return &s->blocks_[0];
+        }
+
+    }; // class body_pool
+
+} // namespace mem
+
+#endif // __MEMORY_SYNC_PTR_POOL_H__
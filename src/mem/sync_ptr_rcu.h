@@ -0,0 +1,112 @@
+
+#ifndef __MEMORY_SYNC_PTR_RCU_H__
+#define __MEMORY_SYNC_PTR_RCU_H__
+
+#include <atomic>
+
+#ifndef __MEMORY_SYNC_PTR_EPOCH_H__
+#include "mem/sync_ptr_epoch.h"
+#endif
+
+
+namespace mem
+{
+
+    /**
+    * \brief RCU read-side critical section scope.
+    * Pointers read from an RCU holder stay valid until the guard is destroyed.
+    */
+    using rcu_read_guard = epoch_guard;
+
+
+    /**
+    * \brief RCU pointer holder.
+    * Readers perform a plain acquire load, to be done inside an rcu_read_guard scope.
+    * Writers publish with release semantics. 
+    * When TWait is true, set() waits for a grace period before handing the previous pointer
+    * to the deleter. Inside a read-side section it can't wait for its own thread: it returns at once
+    * and the chain retires the previous pointer to the epoch domain (see deferring()).
+    * release() and exchange() then hand out a pointer readers may still use.
+    * When TWait is false, set() returns immediately and reclamation must be deferred 
+    * by the deleter (see mem::epoch_deleter).
+    */
+    template <
+        class TPtr,
+        bool TWait>
+    class basic_ptr_holder_rcu
+    {
+
+    private:
+        std::atomic<TPtr *>     ptr_;
+
+    public:
+        inline basic_ptr_holder_rcu(
+            void)
+            noexcept
+            : ptr_(nullptr)
+        {}
+
+        inline explicit basic_ptr_holder_rcu(
+            TPtr * p_ptr)
+            noexcept
+            : ptr_(p_ptr)
+        {}
+
+        inline TPtr * set(
+            TPtr * p_ptr)
+            noexcept
+        {
+            auto p = ptr_.exchange(p_ptr, std::memory_order_acq_rel);
+            if (TWait && p && !epoch_domain::instance().in_section())
+            {
+                epoch_domain::instance().synchronize();
+            }
+            return p;
+        }
+
+        /**
+        * \brief Return true if the pointer previously set can't be freed at once,
+        * set() was called from inside a read-side section and didn't wait.
+        */
+        inline bool deferring(
+            void)
+            const noexcept
+        {
+            return TWait && epoch_domain::instance().in_section();
+        }
+
+        /**
+        * \brief Call target free function on target context once every current reader left.
+        */
+        inline void defer(
+            void * p_ctx,
+            void (*p_free)(void *))
+            const noexcept
+        {
+            epoch_domain::instance().retire(p_ctx, p_free);
+        }
+
+        inline TPtr * get(
+            void)
+            const noexcept
+        {
+            return ptr_.load(std::memory_order_acquire);
+        }
+
+    }; // class basic_ptr_holder_rcu
+
+    /**
+    * \brief RCU pointer holder waiting for a grace period on update.
+    */
+    template <class TPtr>
+    using ptr_holder_rcu = basic_ptr_holder_rcu<TPtr, true>;
+
+    /**
+    * \brief RCU pointer holder leaving reclamation to a deferring deleter.
+    */
+    template <class TPtr>
+    using ptr_holder_rcu_deferred = basic_ptr_holder_rcu<TPtr, false>;
+
+} // namespace mem
+
+#endif // __MEMORY_SYNC_PTR_RCU_H__
@@ -0,0 +1,629 @@
+
+#ifndef __MEMORY_SYNC_PTR_RECLAIM_H__
+#define __MEMORY_SYNC_PTR_RECLAIM_H__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+namespace mem
+{
+
+    /**
+    * \brief Background reclaimer counters, see reclaimer::stats().
+    */
+    struct reclaim_stats
+    {
+        /** \brief Pointers retired. */
+        size_t                      retired_;
+        /** \brief Pointers freed by the reclaimer thread. */
+        size_t                      reclaimed_;
+        /** \brief Pointers freed by the retiring thread (budget exceeded or reclaimer shut down). */
+        size_t                      inline_;
+        /** \brief Pointers retired and not freed yet, batched or queued. */
+        size_t                      queue_depth_;
+        /** \brief Bytes retired and not freed yet. */
+        size_t                      queue_bytes_;
+        /** \brief Batches freed by the reclaimer thread. */
+        size_t                      batches_;
+        /** \brief Longest and total delay between the first retire of a batch and its free. */
+        std::chrono::nanoseconds    latency_max_;
+        std::chrono::nanoseconds    latency_total_;
+
+        inline std::chrono::nanoseconds latency_avg(
+            void)
+            const noexcept
+        {
+            return batches_ ? latency_total_ / static_cast<std::chrono::nanoseconds::rep>(batches_) : std::chrono::nanoseconds(0);
+        }
+
+    }; // struct reclaim_stats
+
+
+    /**
+    * \class mem::reclaimer
+    *
+    * \brief Deferred destruction on a background thread.
+    * Threads retire pointers to a thread-local batch, full batches are handed to the reclaimer thread
+    * which frees them in bulk, so threads losing the last reference don't run destructors.
+    *
+    * Once the bytes retired and not freed yet exceed the budget, retiring threads free inline
+    * until the reclaimer catches up. Bytes are the pointee sizes, memory owned by pointees isn't counted.
+    * flush() frees every batch of every thread, shutdown() flushes and stops the thread,
+    * later retires free inline.
+    *
+    * The reclaimer thread is started on the first handed batch.
+    * Once the process wide reclaimer is destroyed, reclaim_deleter and exiting threads free inline.
+    * \note Pointers freed inline at budget or shutdown count in reclaim_stats::inline_.
+    */
+    class reclaimer final
+    {
+
+    public:
+        typedef void (*free_t)(void *);
+        typedef std::chrono::steady_clock clock_t;
+
+        /** \brief Default pointers per thread batch. */
+        static constexpr size_t default_batch_size = 64U;
+
+        /** \brief Default bytes retired and not freed yet before retiring threads free inline. */
+        static constexpr size_t default_budget = size_t(64U) << 20U;
+
+
+    private:
+        typedef std::chrono::nanoseconds::rep ticks_t;
+
+        struct retired
+        {
+            void *      ptr_;
+            free_t      free_;
+        };
+
+        struct batch
+        {
+            std::vector<retired>    items_;
+            size_t                  bytes_;
+            clock_t::time_point     oldest_;
+
+            batch(
+                void)
+                noexcept
+                : bytes_(0)
+            {}
+        };
+
+        /**
+        * \brief Per-thread batch, its mutex is only contended by flush().
+        */
+        struct record
+        {
+            std::mutex      mutex_;
+            batch           batch_;
+        };
+
+        /**
+        * \brief Thread record owner, hands the batch over on thread exit.
+        * Threads exiting after the reclaimer is destroyed free their batch themselves.
+        */
+        struct local
+        {
+            reclaimer &     reclaimer_;
+            record *        record_;
+
+            explicit local(
+                reclaimer & p_reclaimer)
+                : reclaimer_(p_reclaimer)
+                , record_(p_reclaimer.acquire_record())
+            {}
+
+            ~local(
+                void)
+            {
+                if (!alive())
+                {
+                    for (auto & r : record_->batch_.items_)
+                    {
+                        r.free_(r.ptr_);
+                    }
+                    delete record_;
+                    return;
+                }
+                reclaimer_.release_record(record_);
+            }
+        };
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        std::mutex                  mutex_;
+        std::condition_variable     work_cv_;
+        std::condition_variable     idle_cv_;
+        std::vector<batch>          queue_;
+        std::vector<record *>       records_;
+        std::thread                 thread_;
+        bool                        stop_;
+        bool                        busy_;
+
+        std::atomic<bool>           shutdown_;
+        std::atomic<size_t>         batch_size_;
+        std::atomic<size_t>         budget_;
+
+        std::atomic<size_t>         retired_;
+        std::atomic<size_t>         reclaimed_;
+        std::atomic<size_t>         inline_;
+        std::atomic<size_t>         pending_;
+        std::atomic<size_t>         pending_bytes_;
+        std::atomic<size_t>         batches_;
+        std::atomic<ticks_t>        latency_max_;
+        std::atomic<ticks_t>        latency_total_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        reclaimer(reclaimer const &) = delete;
+        reclaimer(reclaimer &&) = delete;
+        void operator=(reclaimer const &) = delete;
+        void operator=(reclaimer &&) = delete;
+
+    private:
+        reclaimer(
+            void)
+            noexcept
+            // Members.
+            : stop_(false)
+            , busy_(false)
+            , shutdown_(false)
+            , batch_size_(default_batch_size)
+            , budget_(default_budget)
+            , retired_(0)
+            , reclaimed_(0)
+            , inline_(0)
+            , pending_(0)
+            , pending_bytes_(0)
+            , batches_(0)
+            , latency_max_(0)
+            , latency_total_(0)
+        {}
+
+    public:
+        ~reclaimer(
+            void)
+        {
+            shutdown();
+            destroyed().store(true, std::memory_order_release);
+        }
+
+        /**
+        * \brief Process wide reclaimer used by reclaim_deleter.
+        */
+        static reclaimer & instance(
+            void)
+        {
+            static reclaimer r;
+            return r;
+        }
+
+        /**
+        * \brief False once the process wide reclaimer is destroyed (static destruction), instance() is then invalid.
+        */
+        static bool alive(
+            void)
+            noexcept
+        {
+            return !destroyed().load(std::memory_order_acquire);
+        }
+
+
+    public:
+        /**
+        * \brief Defer delete of target pointer to the reclaimer thread.
+        */
+        template<
+            class TType>
+        void retire(
+            TType * p_ptr)
+            noexcept
+        {
+            typedef typename std::remove_cv<TType>::type type_t;
+
+            retire(
+                const_cast<type_t *>(p_ptr),
+                &delete_ptr<type_t>,
+                sizeof(type_t));
+        }
+
+        /**
+        * \brief Defer free of target pointer of target size to the reclaimer thread.
+        */
+        void retire(
+            void * p_ptr,
+            free_t p_free,
+            size_t p_bytes)
+            noexcept
+        {
+            retired_.fetch_add(1U, std::memory_order_relaxed);
+            if (shutdown_.load(std::memory_order_acquire) ||
+                pending_bytes_.load(std::memory_order_relaxed) + p_bytes > budget_.load(std::memory_order_relaxed))
+            {
+                inline_.fetch_add(1U, std::memory_order_relaxed);
+                p_free(p_ptr);
+                return;
+            }
+
+            batch full;
+            try
+            {
+                auto * rec = local_record();
+                std::lock_guard<std::mutex> guard(rec->mutex_);
+                auto & b = rec->batch_;
+                if (b.items_.empty())
+                {
+                    b.oldest_ = clock_t::now();
+                }
+                b.items_.push_back(retired{ p_ptr, p_free });
+                b.bytes_ += p_bytes;
+                if (b.items_.size() >= batch_size_.load(std::memory_order_relaxed))
+                {
+                    std::swap(full, b);
+                }
+            }
+            catch (...)
+            {
+                inline_.fetch_add(1U, std::memory_order_relaxed);
+                p_free(p_ptr);
+                return;
+            }
+            pending_.fetch_add(1U, std::memory_order_relaxed);
+            pending_bytes_.fetch_add(p_bytes, std::memory_order_relaxed);
+
+            if (!full.items_.empty())
+            {
+                hand_over(std::move(full));
+            }
+        }
+
+        /**
+        * \brief Free every pointer retired so far by any thread, return once freed.
+        * Called from the reclaimer thread (by a destructor it runs), frees the queued batches
+        * in place, the batch being freed completes after the call returns.
+        */
+        void flush(
+            void)
+        {
+            std::unique_lock<std::mutex> guard(mutex_);
+            for (auto * rec : records_)
+            {
+                batch b;
+                {
+                    std::lock_guard<std::mutex> rec_guard(rec->mutex_);
+                    std::swap(b, rec->batch_);
+                }
+                if (!b.items_.empty())
+                {
+                    queue_.push_back(std::move(b));
+                }
+            }
+
+            if (std::this_thread::get_id() == thread_.get_id())
+            {
+                // The reclaimer thread can't wait for itself to go idle.
+                std::vector<batch> work;
+                work.swap(queue_);
+                guard.unlock();
+                for (auto & b : work)
+                {
+                    free_batch(b, false);
+                }
+                return;
+            }
+            if (queue_.empty() && !busy_)
+            {
+                return;
+            }
+            if (stop_)
+            {
+                // No reclaimer thread left, drain on the calling thread.
+                std::vector<batch> work;
+                work.swap(queue_);
+                guard.unlock();
+                for (auto & b : work)
+                {
+                    free_batch(b, true);
+                }
+                return;
+            }
+            start();
+            work_cv_.notify_one();
+            idle_cv_.wait(guard, [this]() { return queue_.empty() && !busy_; });
+        }
+
+        /**
+        * \brief Flush and stop the reclaimer thread, later retires free inline.
+        */
+        void shutdown(
+            void)
+        {
+            shutdown_.store(true, std::memory_order_release);
+            flush();
+
+            std::thread t;
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                stop_ = true;
+                t.swap(thread_);
+            }
+            work_cv_.notify_all();
+            if (t.get_id() == std::this_thread::get_id())
+            {
+                // Called from the reclaimer thread, it exits once back in run().
+                t.detach();
+            }
+            else if (t.joinable())
+            {
+                t.join();
+            }
+            // Batches handed while stopping.
+            flush();
+        }
+
+
+    public:
+        /**
+        * \brief Pointers per thread batch, a full batch is handed to the reclaimer thread.
+        */
+        inline void set_batch_size(
+            size_t p_batch_size)
+            noexcept
+        {
+            batch_size_.store((std::max)(p_batch_size, size_t(1U)), std::memory_order_relaxed);
+        }
+
+        inline size_t batch_size(
+            void)
+            const noexcept
+        {
+            return batch_size_.load(std::memory_order_relaxed);
+        }
+
+        /**
+        * \brief Bytes retired and not freed yet before retiring threads free inline.
+        */
+        inline void set_budget(
+            size_t p_budget)
+            noexcept
+        {
+            budget_.store(p_budget, std::memory_order_relaxed);
+        }
+
+        inline size_t budget(
+            void)
+            const noexcept
+        {
+            return budget_.load(std::memory_order_relaxed);
+        }
+
+        reclaim_stats stats(
+            void)
+            const noexcept
+        {
+            return reclaim_stats{
+                retired_.load(std::memory_order_relaxed),
+                reclaimed_.load(std::memory_order_relaxed),
+                inline_.load(std::memory_order_relaxed),
+                pending_.load(std::memory_order_relaxed),
+                pending_bytes_.load(std::memory_order_relaxed),
+                batches_.load(std::memory_order_relaxed),
+                std::chrono::nanoseconds(latency_max_.load(std::memory_order_relaxed)),
+                std::chrono::nanoseconds(latency_total_.load(std::memory_order_relaxed)) };
+        }
+
+
+    private:
+        template<
+            class TType>
+        static void delete_ptr(
+            void * p_ptr)
+        {
+            delete static_cast<TType *>(p_ptr);
+        }
+
+        static std::atomic<bool> & destroyed(
+            void)
+            noexcept
+        {
+            static std::atomic<bool> d(false);
+            return d;
+        }
+
+        record * local_record(
+            void)
+        {
+            static thread_local local l(*this);
+            return l.record_;
+        }
+
+        record * acquire_record(
+            void)
+        {
+            auto * rec = new record();
+            std::lock_guard<std::mutex> guard(mutex_);
+            records_.push_back(rec);
+            return rec;
+        }
+
+        void release_record(
+            record * p_record)
+            noexcept
+        {
+            batch b;
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                records_.erase(std::find(records_.begin(), records_.end(), p_record));
+                std::swap(b, p_record->batch_);
+            }
+            delete p_record;
+            if (!b.items_.empty())
+            {
+                hand_over(std::move(b));
+            }
+        }
+
+        /**
+        * \brief Queue target batch to the reclaimer thread, free it inline once stopped.
+        */
+        void hand_over(
+            batch && p_batch)
+            noexcept
+        {
+            {
+                std::lock_guard<std::mutex> guard(mutex_);
+                if (!stop_)
+                {
+                    try
+                    {
+                        start();
+                        queue_.push_back(std::move(p_batch));
+                    }
+                    catch (...)
+                    {}
+                }
+            }
+            if (p_batch.items_.empty())
+            {
+                work_cv_.notify_one();
+                return;
+            }
+            free_batch(p_batch, true);
+        }
+
+        /**
+        * \brief Start the reclaimer thread if not running yet, called under mutex_.
+        */
+        void start(
+            void)
+        {
+            if (!thread_.joinable())
+            {
+                thread_ = std::thread([this]() { run(); });
+            }
+        }
+
+        void run(
+            void)
+        {
+            std::unique_lock<std::mutex> guard(mutex_);
+            for (;;)
+            {
+                work_cv_.wait(guard, [this]() { return stop_ || !queue_.empty(); });
+                if (queue_.empty())
+                {
+                    return;
+                }
+                std::vector<batch> work;
+                work.swap(queue_);
+                busy_ = true;
+                guard.unlock();
+
+                for (auto & b : work)
+                {
+                    free_batch(b, false);
+                }
+
+                guard.lock();
+                busy_ = false;
+                idle_cv_.notify_all();
+            }
+        }
+
+        /**
+        * \brief Free target batch, on the calling thread if p_inline is true.
+        */
+        void free_batch(
+            batch & p_batch,
+            bool p_inline)
+            noexcept
+        {
+            for (auto & r : p_batch.items_)
+            {
+                r.free_(r.ptr_);
+            }
+            pending_.fetch_sub(p_batch.items_.size(), std::memory_order_relaxed);
+            pending_bytes_.fetch_sub(p_batch.bytes_, std::memory_order_relaxed);
+            if (p_inline)
+            {
+                inline_.fetch_add(p_batch.items_.size(), std::memory_order_relaxed);
+                p_batch.items_.clear();
+                return;
+            }
+
+            auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                clock_t::now() - p_batch.oldest_).count();
+            auto max = latency_max_.load(std::memory_order_relaxed);
+            while (max < latency && !latency_max_.compare_exchange_weak(
+                max,
+                latency,
+                std::memory_order_relaxed))
+            {}
+            latency_total_.fetch_add(latency, std::memory_order_relaxed);
+
+            reclaimed_.fetch_add(p_batch.items_.size(), std::memory_order_relaxed);
+            batches_.fetch_add(1U, std::memory_order_relaxed);
+            p_batch.items_.clear();
+        }
+
+    }; // class reclaimer
+
+
+    /**
+    * \brief Background reclamation deleter used by smart pointer(s).
+    * Retires pointer to the process wide reclaimer, "delete" is called on its thread.
+    */
+    template<
+        class TType>
+    struct reclaim_deleter
+    {
+        constexpr reclaim_deleter(
+            void)
+            noexcept = default;
+
+        template<
+            class TType2,
+            class = typename std::enable_if<std::is_convertible<TType2 *, TType *>::value, void>::type>
+            reclaim_deleter(reclaim_deleter<TType2> const &)
+            noexcept
+        {}
+
+        void free(
+            TType * p_ptr)
+            const noexcept
+        {
+            static_assert(
+                0 < sizeof(TType),
+                "can't delete an incomplete type");
+            if (!reclaimer::alive())
+            {
+                delete p_ptr;
+                return;
+            }
+            reclaimer::instance().retire(p_ptr);
+        }
+
+    }; // struct reclaim_deleter
+
+} // namespace mem
+
+#endif // __MEMORY_SYNC_PTR_RECLAIM_H__
@@ -0,0 +1,236 @@
+
+#ifndef __MEMORY_SYNC_PTR_SHARDED_H__
+#define __MEMORY_SYNC_PTR_SHARDED_H__
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+#ifndef __MEMORY_SYNC_PTR_POLICY_H__
+#include "mem/sync_ptr_policy.h"
+#endif
+
+
+namespace mem
+{
+
+    /**
+    * \brief Sharded reference counter.
+    * Counts are spread on TSlots cache line sized slots, threads are assigned a home slot round-robin.
+    * A root counter holds the number of non-zero slots (SNZI), it is only written
+    * when a slot goes from zero to non-zero and back.
+    *
+    * Increments land on the home slot. Decrements take any non-zero slot, starting with the home one,
+    * so references may be dropped by another thread than the one that took them.
+    * The root counter only drops to zero with the very last reference, which is reported exactly once.
+    *
+    * decrement() and decrement_ptr() return 1 on last release, 2 otherwise.
+    * count() and count_ptr() sum the slots and are only exact when no other thread is counting.
+    *
+    * \note Each count is a leading pad line, a root line and TSlots slot lines, a counter takes
+    * (TSlots + 2) * 2 cache lines, meant for a few massively shared chains.
+    */
+    template <
+        size_t TSlots>
+    class basic_sharded_ref_counter
+    {
+        static_assert(
+            TSlots > 0,
+            "Sharded counter needs at least one slot.");
+
+    private:
+        struct slot
+        {
+            std::atomic<size_t>     count_;
+            char                    pad_[cache_line_size - sizeof(std::atomic<size_t>)];
+        };
+
+        struct sharded_count
+        {
+            char                    pad_[cache_line_size];
+            std::atomic<size_t>     root_;
+            char                    pad_root_[cache_line_size - sizeof(std::atomic<size_t>)];
+            slot                    slots_[TSlots];
+
+            explicit sharded_count(
+                size_t p_count)
+                noexcept
+                : root_(p_count ? 1U : 0)
+            {
+                for (auto & s : slots_)
+                {
+                    s.count_.store(0, std::memory_order_relaxed);
+                }
+                slots_[0].count_.store(p_count, std::memory_order_relaxed);
+            }
+        };
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        sharded_count   ref_count_;
+        sharded_count   ref_count_ptr_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        inline basic_sharded_ref_counter(
+            void)
+            noexcept
+            : ref_count_(1U)
+            , ref_count_ptr_(0)
+        {}
+
+        inline void increment(
+            void)
+            noexcept
+        {
+            add(ref_count_);
+        }
+
+        inline size_t decrement(
+            void)
+            noexcept
+        {
+            return sub(ref_count_);
+        }
+
+        inline void increment_ptr(
+            void)
+            noexcept
+        {
+            add(ref_count_ptr_);
+        }
+
+        inline size_t decrement_ptr(
+            void)
+            noexcept
+        {
+            return sub(ref_count_ptr_);
+        }
+
+        inline size_t count(
+            void)
+            const noexcept
+        {
+            return total(ref_count_);
+        }
+
+        inline size_t count_ptr(
+            void)
+            const noexcept
+        {
+            return total(ref_count_ptr_);
+        }
+
+
+    private:
+        static size_t home(
+            void)
+            noexcept
+        {
+            static std::atomic<size_t> next(0);
+            static thread_local size_t index = next.fetch_add(1U, std::memory_order_relaxed) % TSlots;
+            return index;
+        }
+
+        static size_t total(
+            sharded_count const & p_count)
+            noexcept
+        {
+            size_t n = 0;
+            for (auto & s : p_count.slots_)
+            {
+                n += s.count_.load(std::memory_order_acquire);
+            }
+            return n;
+        }
+
+        static void add(
+            sharded_count & p_count)
+            noexcept
+        {
+            auto & s = p_count.slots_[home()];
+            auto n = s.count_.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                if (n > 0)
+                {
+                    if (s.count_.compare_exchange_weak(
+                        n,
+                        n + 1U,
+                        std::memory_order_relaxed))
+                    {
+                        return;
+                    }
+                }
+                else
+                {
+                    // Announce the slot to the root before it becomes visible.
+                    p_count.root_.fetch_add(1U, std::memory_order_relaxed);
+                    if (s.count_.compare_exchange_strong(
+                        n,
+                        1U,
+                        std::memory_order_release,
+                        std::memory_order_relaxed))
+                    {
+                        return;
+                    }
+                    p_count.root_.fetch_sub(1U, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        static size_t sub(
+            sharded_count & p_count)
+            noexcept
+        {
+            auto start = home();
+            for (;;)
+            {
+                for (size_t i = 0; i < TSlots; ++i)
+                {
+                    auto & s = p_count.slots_[(start + i) % TSlots];
+                    auto n = s.count_.load(std::memory_order_relaxed);
+                    while (n > 0)
+                    {
+                        if (s.count_.compare_exchange_weak(
+                            n,
+                            n - 1U,
+                            std::memory_order_acq_rel,
+                            std::memory_order_relaxed))
+                        {
+                            if (n > 1U)
+                            {
+                                return 2U;
+                            }
+                            return p_count.root_.fetch_sub(1U, std::memory_order_acq_rel) == 1U ? 1U : 2U;
+                        }
+                    }
+                }
+
+                // Every slot was seen empty: an increment is in flight, or nothing is left to drop.
+                if (p_count.root_.load(std::memory_order_acquire) == 0)
+                {
+                    return 2U;
+                }
+                std::this_thread::yield();
+            }
+        }
+
+    }; // class basic_sharded_ref_counter
+
+    /**
+    * \brief Sharded reference counter with eight slots.
+    */
+    using sharded_ref_counter = basic_sharded_ref_counter<8U>;
+
+} // namespace mem
+
+#endif // __MEMORY_SYNC_PTR_SHARDED_H__
@@ -0,0 +1,527 @@
+
+#ifndef __MEMORY_SYNC_PTR_TABLE_H__
+#define __MEMORY_SYNC_PTR_TABLE_H__
+
+#include <cassert>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef __MEMORY_SYNC_PTR_H__
+#include "mem/sync_ptr.h"
+#endif
+
+
+namespace mem
+{
+
+    /**
+    * \class mem::sync_handle
+    *
+    * \brief 32 bits reference to a sync_table chain: slot index in the low bits, slot generation above.
+    * Generation 0 is never issued, a default constructed handle is null.
+    */
+    template<
+        unsigned TIndexBits = 20U>
+    class sync_handle final
+    {
+        static_assert(
+            0 < TIndexBits && TIndexBits < 32U,
+            "Handles need index and generation bits.");
+
+    public:
+        static constexpr unsigned index_bits = TIndexBits;
+        static constexpr unsigned generation_bits = 32U - TIndexBits;
+        static constexpr std::uint32_t index_mask = (std::uint32_t(1U) << TIndexBits) - 1U;
+        static constexpr std::uint32_t generation_mask = (std::uint32_t(1U) << generation_bits) - 1U;
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        std::uint32_t   value_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        constexpr sync_handle(
+            void)
+            noexcept
+            // Members.
+            : value_(0)
+        {}
+
+        constexpr sync_handle(
+            std::uint32_t p_index,
+            std::uint32_t p_generation)
+            noexcept
+            // Members.
+            : value_((p_generation << TIndexBits) | (p_index & index_mask))
+        {}
+
+        /**
+        * \brief Handle from its 32 bits value, as stored.
+        */
+        static constexpr sync_handle from_value(
+            std::uint32_t p_value)
+            noexcept
+        {
+            return sync_handle(p_value & index_mask, p_value >> TIndexBits);
+        }
+
+
+    public:
+        inline constexpr std::uint32_t index(
+            void)
+            const noexcept
+        {
+            return value_ & index_mask;
+        }
+
+        inline constexpr std::uint32_t generation(
+            void)
+            const noexcept
+        {
+            return value_ >> TIndexBits;
+        }
+
+        inline constexpr std::uint32_t value(
+            void)
+            const noexcept
+        {
+            return value_;
+        }
+
+        inline constexpr operator bool(
+            void)
+            const noexcept
+        {
+            return generation() != 0;
+        }
+
+        inline constexpr bool operator==(
+            sync_handle const & p_other)
+            const noexcept
+        {
+            return value_ == p_other.value_;
+        }
+
+        inline constexpr bool operator!=(
+            sync_handle const & p_other)
+            const noexcept
+        {
+            return value_ != p_other.value_;
+        }
+
+    }; // class sync_handle
+
+
+    /**
+    * \class mem::sync_table
+    *
+    * \brief Chains stored in a chunked slot table and referenced by 32 bits sync_handle.
+    * A slot holds what a sync_ptr body holds, a pointer holder and a reference counter, built from
+    * the same policies: create() starts a chain counted once, retain() and release() count copies,
+    * reset() replaces the pointee for every handle and the last release() frees it.
+    * Handles don't count themselves, each retain() or create() must be paired with one release().
+    *
+    * Slots are allocated chunk by chunk and never move, lookups are lock-free.
+    * Chains created in a row on fresh chunks get neighboring slots.
+    * Freeing a slot bumps its generation and queues it behind every other free slot,
+    * so stale handles are detected, and retain(), release() and reset() reject them,
+    * until their slot was freed 2^generation_bits - 1 more times (4095 with the default 20 index bits).
+    * Handles used concurrently must be counted, a stale check can't race the release of the chain.
+    *
+    * \note Like sync_ptr::get(), returned pointers are only protected from concurrent resets by the deleter policy.
+    * Counter policies reporting releases outside of decrement (biased_ref_counter) aren't supported.
+    */
+    template <
+        class TPtr,
+        template <class T> class TDeleter = sync_ptr_deleter,
+        template <class T> class THolder = sync_ptr_holder,
+        class TRefCounter = sync_ptr_ref_counter,
+        unsigned TIndexBits = 20U>
+    class sync_table final
+        : private TDeleter<TPtr>
+    {
+        static_assert(
+            8U <= TIndexBits,
+            "Tables need at least 256 slots.");
+
+    public:
+        typedef TPtr                        pointer_type;
+        typedef TDeleter<TPtr>              deleter_type;
+        typedef THolder<TPtr>               holder_type;
+        typedef TRefCounter                 reference_counter_type;
+        typedef sync_handle<TIndexBits>     handle_type;
+
+        /** \brief Slots per chunk. */
+        static constexpr size_t chunk_bits = TIndexBits < 12U ? TIndexBits : 12U;
+        static constexpr size_t chunk_size = size_t(1U) << chunk_bits;
+        static constexpr size_t max_chunks = size_t(1U) << (TIndexBits - chunk_bits);
+
+
+    private:
+        /**
+        * \brief Chain state of a slot, constructed on create() and destroyed on the last release().
+        */
+        struct chain
+            : public THolder<TPtr>
+            , public TRefCounter
+        {
+            explicit chain(
+                TPtr * p_ptr)
+                noexcept
+                // Inheritance.
+                : THolder<TPtr>(p_ptr)
+            {}
+
+        }; // struct chain
+
+        struct slot
+        {
+            // Generation shifted left once, low bit set while the chain is live.
+            std::atomic<std::uint32_t>      state_;
+            typename std::aligned_storage<sizeof(chain), alignof(chain)>::type storage_;
+
+            slot(
+                void)
+                noexcept
+                // Members.
+                : state_(1U << 1U)
+            {}
+
+            inline chain * get_chain(
+                void)
+                noexcept
+            {
+                return reinterpret_cast<chain *>(&storage_);
+            }
+
+        }; // struct slot
+
+
+        //////////////////////////////////////
+        //              MEMBERS             //
+        //////////////////////////////////////
+
+    private:
+        std::unique_ptr<std::atomic<slot *>[]>  chunks_;
+        std::mutex                              mutex_;
+        // Free slot queue, a ring sized for every slot so release() never allocates.
+        std::vector<std::uint32_t>              free_;
+        size_t                                  free_head_;
+        size_t                                  free_count_;
+        size_t                                  chunk_count_;
+        std::atomic<size_t>                     size_;
+
+
+        //////////////////////////////////////
+        //              METHODS             //
+        //////////////////////////////////////
+
+    public:
+        sync_table(sync_table const &) = delete;
+        sync_table(sync_table &&) = delete;
+        void operator=(sync_table const &) = delete;
+        void operator=(sync_table &&) = delete;
+
+    public:
+        sync_table(
+            void)
+            // Members.
+            : chunks_(new std::atomic<slot *>[max_chunks])
+            , free_head_(0)
+            , free_count_(0)
+            , chunk_count_(0)
+            , size_(0)
+        {
+            for (size_t i = 0; i < max_chunks; ++i)
+            {
+                chunks_[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+        * \brief Free pointees of the chains still live, handles to them become dangling.
+        */
+        ~sync_table(
+            void)
+        {
+            for (size_t c = 0; c < chunk_count_; ++c)
+            {
+                auto * chunk = chunks_[c].load(std::memory_order_relaxed);
+                for (size_t i = 0; i < chunk_size; ++i)
+                {
+                    if (chunk[i].state_.load(std::memory_order_relaxed) & 1U)
+                    {
+                        destroy(chunk[i]);
+                    }
+                }
+                delete[] chunk;
+            }
+        }
+
+
+    public:
+        /**
+        * \brief Start a chain holding target pointer, counted once.
+        * Throws std::bad_alloc when every index is in use, target pointer is freed then.
+        */
+        handle_type create(
+            TPtr * p_ptr)
+        {
+            std::uint32_t index = 0;
+            try
+            {
+                index = acquire_index();
+            }
+            catch (...)
+            {
+                if (p_ptr)
+                {
+                    this->free(p_ptr);
+                }
+                throw;
+            }
+
+            auto & s = at(index);
+            ::new (&s.storage_) chain(p_ptr);
+            auto generation = s.state_.load(std::memory_order_relaxed) >> 1U;
+            s.state_.store((generation << 1U) | 1U, std::memory_order_release);
+            size_.fetch_add(1U, std::memory_order_relaxed);
+            return handle_type(index, generation);
+        }
+
+        template<
+            class... TArgs>
+        inline handle_type emplace(
+            TArgs&&... p_args)
+        {
+            return create(new TPtr(std::forward<TArgs>(p_args)...));
+        }
+
+        /**
+        * \brief Count one more handle to target chain.
+        * Return false for a stale or null handle.
+        */
+        inline bool retain(
+            handle_type p_handle)
+            noexcept
+        {
+            auto * s = find(p_handle);
+            if (!s)
+            {
+                return false;
+            }
+            s->get_chain()->increment();
+            return true;
+        }
+
+        /**
+        * \brief Drop one handle to target chain, the last one frees the pointee and the slot.
+        * Return false for a stale or null handle.
+        */
+        bool release(
+            handle_type p_handle)
+            noexcept
+        {
+            auto * s = find(p_handle);
+            if (!s)
+            {
+                return false;
+            }
+            if (s->get_chain()->decrement() != 1U)
+            {
+                return true;
+            }
+
+            destroy(*s);
+            auto generation = next_generation(p_handle.generation());
+            s->state_.store(generation << 1U, std::memory_order_release);
+            size_.fetch_sub(1U, std::memory_order_relaxed);
+
+            std::lock_guard<std::mutex> guard(mutex_);
+            free_[(free_head_ + free_count_) % free_.size()] = p_handle.index();
+            ++free_count_;
+            return true;
+        }
+
+        /**
+        * \brief Replace the pointee of target chain for every handle, the previous one is freed.
+        * Return false for a stale or null handle, target pointer is freed then.
+        */
+        bool reset(
+            handle_type p_handle,
+            TPtr * p_ptr)
+            noexcept
+        {
+            auto * s = find(p_handle);
+            if (!s)
+            {
+                if (p_ptr)
+                {
+                    this->free(p_ptr);
+                }
+                return false;
+            }
+            auto * c = s->get_chain();
+            assert((!p_ptr || p_ptr != c->get()) && "Pointer is already the chain pointee.");
+            auto * old = c->set(p_ptr);
+            if (old)
+            {
+                this->free(old);
+            }
+            return true;
+        }
+
+        inline bool reset(
+            handle_type p_handle)
+            noexcept
+        {
+            return reset(p_handle, nullptr);
+        }
+
+
+    public:
+        /**
+        * \brief Pointee of target chain, nullptr for a stale or null handle.
+        */
+        inline TPtr * get(
+            handle_type p_handle)
+            const noexcept
+        {
+            auto * s = find(p_handle);
+            return s ? s->get_chain()->get() : nullptr;
+        }
+
+        /**
+        * \brief Whether target handle refers to a live chain.
+        */
+        inline bool valid(
+            handle_type p_handle)
+            const noexcept
+        {
+            return find(p_handle) != nullptr;
+        }
+
+        /**
+        * \brief Number of handles counted on target chain, 0 for a stale handle.
+        */
+        inline size_t count(
+            handle_type p_handle)
+            const noexcept
+        {
+            auto * s = find(p_handle);
+            return s ? s->get_chain()->count() : 0;
+        }
+
+        /**
+        * \brief Number of live chains.
+        */
+        inline size_t size(
+            void)
+            const noexcept
+        {
+            return size_.load(std::memory_order_relaxed);
+        }
+
+
+    private:
+        inline slot & at(
+            std::uint32_t p_index)
+            const noexcept
+        {
+            auto * chunk = chunks_[p_index >> chunk_bits].load(std::memory_order_acquire);
+            return chunk[p_index & (chunk_size - 1U)];
+        }
+
+        inline slot * find(
+            handle_type p_handle)
+            const noexcept
+        {
+            if (!p_handle)
+            {
+                return nullptr;
+            }
+            auto * chunk = chunks_[p_handle.index() >> chunk_bits].load(std::memory_order_acquire);
+            if (!chunk)
+            {
+                return nullptr;
+            }
+            auto * s = &chunk[p_handle.index() & (chunk_size - 1U)];
+            auto state = s->state_.load(std::memory_order_acquire);
+            return state == ((p_handle.generation() << 1U) | 1U) ? s : nullptr;
+        }
+
+        /**
+        * \brief Pop the longest free index, growing the table by one chunk when none is left.
+        */
+        std::uint32_t acquire_index(
+            void)
+        {
+            std::lock_guard<std::mutex> guard(mutex_);
+            if (!free_count_)
+            {
+                if (chunk_count_ == max_chunks)
+                {
+                    throw std::bad_alloc();
+                }
+                std::unique_ptr<slot[]> chunk(new slot[chunk_size]);
+
+                // The queue is empty, restart it with room for every slot.
+                std::vector<std::uint32_t> ring((chunk_count_ + 1U) * chunk_size);
+                auto first = static_cast<std::uint32_t>(chunk_count_ << chunk_bits);
+                for (std::uint32_t i = 0; i < chunk_size; ++i)
+                {
+                    ring[i] = first + i;
+                }
+                free_.swap(ring);
+                free_head_ = 0;
+                free_count_ = chunk_size;
+                chunks_[chunk_count_].store(chunk.release(), std::memory_order_release);
+                ++chunk_count_;
+            }
+            auto index = free_[free_head_];
+            free_head_ = (free_head_ + 1U) % free_.size();
+            --free_count_;
+            return index;
+        }
+
+        inline void destroy(
+            slot & p_slot)
+            noexcept
+        {
+            auto * c = p_slot.get_chain();
+            auto * ptr = c->set(nullptr);
+            if (ptr)
+            {
+                this->free(ptr);
+            }
+            c->~chain();
+        }
+
+        static inline std::uint32_t next_generation(
+            std::uint32_t p_generation)
+            noexcept
+        {
+            auto generation = (p_generation + 1U) & handle_type::generation_mask;
+            return generation ? generation : 1U;
+        }
+
+    }; // class sync_table
+
+} // namespace mem
+
+#endif // __MEMORY_SYNC_PTR_TABLE_H__
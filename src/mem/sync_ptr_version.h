@@ -0,0 +1,111 @@
+
+#ifndef __MEMORY_SYNC_PTR_VERSION_H__
+#define __MEMORY_SYNC_PTR_VERSION_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace mem
+{
+
+    class version_waiter;
+
+
+    /**
+    * \brief Version word threads can sleep on until it changes (see mem/sync_ptr_wait.h).
+    * The version is kept in the upper 31 bits, bit 0 flags sleeping waiters
+    * so bump() only wakes through the kernel when a thread waits.
+    */
+    class version_word
+    {
+
+        friend class version_waiter;
+
+    private:
+        typedef void (*wake_t)(std::atomic<std::uint32_t> const *);
+
+    private:
+        static constexpr std::uint32_t waiting = 1U;
+        static constexpr std::uint32_t one = 2U;
+
+    private:
+        mutable std::atomic<std::uint32_t>  word_;
+
+        static_assert(
+            sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t),
+            "Version word must be a plain 32 bits word to be waited on.");
+
+
+    public:
+        version_word(
+            void)
+            noexcept
+            : word_(0)
+        {}
+
+        inline size_t load(
+            std::memory_order p_order)
+            const noexcept
+        {
+            return word_.load(p_order) / one;
+        }
+
+        /**
+        * \brief Increment version and wake every waiter.
+        */
+        inline void bump(
+            void)
+            noexcept
+        {
+            if (word_.fetch_add(one, std::memory_order_acq_rel) & waiting)
+            {
+                word_.fetch_and(~waiting, std::memory_order_relaxed);
+                auto wake = waker().load(std::memory_order_acquire);
+                if (wake)
+                {
+                    wake(&word_);
+                }
+            }
+        }
+
+
+    private:
+        /**
+        * \brief Wake function, set by waiters before they flag themselves,
+        * so only programs waiting on versions pull in the platform wait primitives.
+        */
+        static std::atomic<wake_t> & waker(
+            void)
+            noexcept
+        {
+            static std::atomic<wake_t> wake(nullptr);
+            return wake;
+        }
+
+    }; // class version_word
+
+
+    /**
+    * \brief Version word of a chain, for the wait entry points of mem/sync_ptr_wait.h.
+    */
+    struct version_access
+    {
+        /**
+        * \brief Return the version word of target sync_ptr chain, nullptr for an empty sync_ptr.
+        */
+        template<
+            class TChain>
+        static inline version_word const * of(
+            TChain const & p_chain)
+            noexcept
+        {
+            return p_chain.body_ ? &p_chain.body_->get_version_word() : nullptr;
+        }
+
+    }; // struct version_access
+
+} // namespace mem
+
+#endif // __MEMORY_SYNC_PTR_VERSION_H__
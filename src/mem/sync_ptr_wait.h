@@ -0,0 +1,238 @@
+
+#ifndef __MEMORY_SYNC_PTR_WAIT_H__
+#define __MEMORY_SYNC_PTR_WAIT_H__
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#pragma comment(lib, "Synchronization.lib")
+#endif
+
+#ifndef __MEMORY_SYNC_PTR_VERSION_H__
+#include "mem/sync_ptr_version.h"
+#endif
+
+
+namespace mem
+{
+
+    /**
+    * \brief Sleeps on a version_word until it changes.
+    * Sleeps use futex on Linux, WaitOnAddress on Windows and a polling sleep elsewhere.
+    */
+    class version_waiter final
+    {
+
+    public:
+        /**
+        * \brief Block until version differs from target one, return the new version.
+        */
+        static inline size_t wait(
+            version_word const & p_word,
+            size_t p_version)
+            noexcept
+        {
+            size_t v = p_version;
+            while (!sleep(p_word, p_version, v, nullptr))
+            {}
+            return v;
+        }
+
+        /**
+        * \brief Block until version differs from target one or deadline is reached.
+        * Return the version, equal to the target one on timeout.
+        */
+        template<
+            class TClock,
+            class TDuration>
+        static inline size_t wait_until(
+            version_word const & p_word,
+            size_t p_version,
+            std::chrono::time_point<TClock, TDuration> const & p_deadline)
+            noexcept
+        {
+            size_t v = p_version;
+            for (;;)
+            {
+                auto left = std::chrono::duration_cast<std::chrono::nanoseconds>(p_deadline - TClock::now());
+                if (left.count() <= 0)
+                {
+                    return p_word.load(std::memory_order_acquire);
+                }
+                if (sleep(p_word, p_version, v, &left))
+                {
+                    return v;
+                }
+            }
+        }
+
+
+    private:
+        /**
+        * \brief Sleep once unless version changed, return true and set p_current if it did.
+        * Spurious wakes and timeouts return false.
+        */
+        static inline bool sleep(
+            version_word const & p_word,
+            size_t p_version,
+            size_t & p_current,
+            std::chrono::nanoseconds const * p_timeout)
+            noexcept
+        {
+            auto & word = p_word.word_;
+            version_word::waker().store(&wake_all, std::memory_order_release);
+            auto w = word.load(std::memory_order_acquire);
+            for (;;)
+            {
+                if (w / version_word::one != static_cast<std::uint32_t>(p_version))
+                {
+                    p_current = w / version_word::one;
+                    return true;
+                }
+                if (w & version_word::waiting)
+                {
+                    break;
+                }
+                if (word.compare_exchange_weak(
+                    w,
+                    w | version_word::waiting,
+                    std::memory_order_acq_rel,
+                    std::memory_order_acquire))
+                {
+                    w |= version_word::waiting;
+                    break;
+                }
+            }
+            wait_on(word, w, p_timeout);
+            return false;
+        }
+
+#if defined(__linux__)
+        static inline void wait_on(
+            std::atomic<std::uint32_t> const & p_word,
+            std::uint32_t p_expected,
+            std::chrono::nanoseconds const * p_timeout)
+            noexcept
+        {
+            timespec ts;
+            timespec * pts = nullptr;
+            if (p_timeout)
+            {
+                ts.tv_sec = static_cast<time_t>(p_timeout->count() / 1000000000);
+                ts.tv_nsec = static_cast<long>(p_timeout->count() % 1000000000);
+                pts = &ts;
+            }
+            ::syscall(SYS_futex, &p_word, FUTEX_WAIT_PRIVATE, p_expected, pts, nullptr, 0);
+        }
+
+        static void wake_all(
+            std::atomic<std::uint32_t> const * p_word)
+            noexcept
+        {
+            ::syscall(SYS_futex, p_word, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+        }
+#elif defined(_WIN32)
+        static inline void wait_on(
+            std::atomic<std::uint32_t> const & p_word,
+            std::uint32_t p_expected,
+            std::chrono::nanoseconds const * p_timeout)
+            noexcept
+        {
+            DWORD ms = INFINITE;
+            if (p_timeout)
+            {
+                auto rounded = std::chrono::ceil<std::chrono::milliseconds>(*p_timeout).count();
+                ms = static_cast<DWORD>((std::min)(rounded, static_cast<decltype(rounded)>(INFINITE - 1U)));
+            }
+            ::WaitOnAddress(
+                const_cast<std::atomic<std::uint32_t> *>(&p_word),
+                &p_expected,
+                sizeof(p_expected),
+                ms);
+        }
+
+        static void wake_all(
+            std::atomic<std::uint32_t> const * p_word)
+            noexcept
+        {
+            ::WakeByAddressAll(const_cast<std::atomic<std::uint32_t> *>(p_word));
+        }
+#else
+        static inline void wait_on(
+            std::atomic<std::uint32_t> const & p_word,
+            std::uint32_t p_expected,
+            std::chrono::nanoseconds const * p_timeout)
+            noexcept
+        {
+            std::chrono::nanoseconds nap = std::chrono::microseconds(100);
+            if (p_timeout)
+            {
+                nap = (std::min)(nap, *p_timeout);
+            }
+            if (p_word.load(std::memory_order_relaxed) == p_expected)
+            {
+                std::this_thread::sleep_for(nap);
+            }
+        }
+
+        static void wake_all(
+            std::atomic<std::uint32_t> const *)
+            noexcept
+        {}
+#endif
+
+    }; // class version_waiter
+
+
+    /**
+    * \brief Block until the version of target chain differs from target one, return the new version.
+    * Waiters sleep in the kernel and are woken by the next pointer change or notify().
+    * Empty sync_ptr return at once.
+    */
+    template<
+        class TChain>
+    inline size_t wait_for_change(
+        TChain const & p_chain,
+        size_t p_version)
+        noexcept
+    {
+        auto * word = version_access::of(p_chain);
+        return word ? version_waiter::wait(*word, p_version) : p_chain.version();
+    }
+
+    /**
+    * \brief Block until the version of target chain differs from target one or deadline is reached.
+    * Return the version, equal to the target one on timeout.
+    */
+    template<
+        class TChain,
+        class TClock,
+        class TDuration>
+    inline size_t wait_for_change_until(
+        TChain const & p_chain,
+        size_t p_version,
+        std::chrono::time_point<TClock, TDuration> const & p_deadline)
+        noexcept
+    {
+        auto * word = version_access::of(p_chain);
+        return word ? version_waiter::wait_until(*word, p_version, p_deadline) : p_chain.version();
+    }
+
+} // namespace mem
+
+#endif // __MEMORY_SYNC_PTR_WAIT_H__
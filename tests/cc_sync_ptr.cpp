@@ -3,6 +3,11 @@
 #include "cc_sync_ptr.h"
 
 #include <cassert>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 
 void tests::cc_sync_ptr_synchro(void)
@@ -117,3 +122,448 @@ void tests::cc_sync_ptr_allocator(void)
     }
     assert(test_allocator_called);
 }
+
+
+
+void tests::cc_sync_ptr_inplace(void)
+{
+    static int alive = 0;
+    struct Obj
+    {
+        int value_;
+        Obj(int p_value) : value_(p_value) { ++alive; }
+        Obj(Obj && p_other) : value_(p_other.value_) { ++alive; }
+        ~Obj(void) { --alive; }
+    };
+
+    {
+        cc::sync_ptr<Obj> obj1 = cc::make_sync_inplace<Obj>(42);
+        cc::sync_ptr<Obj> obj2(obj1);
+        assert(obj1);
+        assert(obj1 == obj2);
+        assert(obj1->value_ == 42);
+        assert(alive == 1);
+
+        // In place slot is destroyed, chain falls back to separate pointee.
+        obj1.reset(new Obj(7));
+        assert(alive == 1);
+        assert(obj1 == obj2);
+        assert(obj2->value_ == 7);
+    }
+    assert(alive == 0);
+
+    {
+        cc::sync_ptr<Obj> ptr = cc::make_sync_inplace<Obj>(42);
+        Obj * addr = ptr.get();
+
+        // Released pointee leaves the shared allocation.
+        Obj * raw = nullptr;
+        bool ret = ptr.release(&raw);
+        assert(ret);
+        assert(raw);
+        assert(raw != addr);
+        assert(raw->value_ == 42);
+        assert(!ptr);
+        delete raw;
+    }
+    assert(alive == 0);
+}
+
+void tests::cc_sync_ptr_layout(void)
+{
+    class Obj
+    {};
+
+    static_assert(
+        sizeof(cc::padded_body_layout<Obj>) >= 3U * mem::cache_line_size,
+        "Padded layout must spread counters and pointer over cache lines.");
+
+    typedef cc::sync_ptr<Obj, cc::sync_ptr_deleter, cc::padded_body_layout> sync_ptr_t;
+
+    sync_ptr_t obj1 = cc::make_sync<Obj, cc::sync_ptr_deleter, cc::padded_body_layout>();
+    sync_ptr_t obj2(obj1);
+    assert(obj1 == obj2);
+    assert(obj1.count() == 2U);
+
+    obj1.reset(new Obj());
+    assert(obj1 == obj2);
+
+    {
+        sync_ptr_t obj3(obj2);
+        assert(obj1.count() == 3U);
+    }
+    assert(obj1.count() == 2U);
+}
+
+namespace
+{
+    typedef cc::sync_ptr<int> int_sync_ptr_t;
+
+    int read_ref(cc::sync_ref<int> p_ref)
+    {
+        return *p_ref;
+    }
+
+} // namespace
+
+void tests::cc_sync_ptr_ref(void)
+{
+    int_sync_ptr_t ptr(new int(42));
+    assert(ptr.count() == 1U);
+
+    // Borrowing leaves counts untouched.
+    cc::sync_ref<int> ref(ptr);
+    assert(read_ref(ptr) == 42);
+    assert(read_ref(ref) == 42);
+    assert(ref.get() == ptr.get());
+    assert(ptr.count() == 1U);
+
+    // View follows the chain.
+    bool ret = ptr.reset(new int(7));
+    assert(ret);
+    assert(*ref == 7);
+
+    // Upgraded view joins the chain.
+    int_sync_ptr_t escaped = ref.sync();
+    assert(ptr.count() == 2U);
+    assert(escaped == ptr);
+    ret = escaped.reset(new int(8));
+    assert(ret);
+    assert(*ptr == 8);
+}
+
+namespace
+{
+    int destroyed_count = 0;
+
+    /**
+    * \brief Allocator counting the objects it destroys.
+    */
+    template<class TType>
+    struct destroy_counting_allocator
+    {
+        typedef TType value_type;
+
+        destroy_counting_allocator(void) noexcept = default;
+
+        template<class TOther>
+        destroy_counting_allocator(destroy_counting_allocator<TOther> const &) noexcept {}
+
+        TType * allocate(size_t p_count) { return std::allocator<TType>().allocate(p_count); }
+        void deallocate(TType * p_ptr, size_t p_count) noexcept { std::allocator<TType>().deallocate(p_ptr, p_count); }
+
+        template<class TOther>
+        void destroy(TOther * p_ptr) { ++destroyed_count; p_ptr->~TOther(); }
+
+        template<class TOther>
+        bool operator==(destroy_counting_allocator<TOther> const &) const noexcept { return true; }
+        template<class TOther>
+        bool operator!=(destroy_counting_allocator<TOther> const &) const noexcept { return false; }
+    };
+
+#if defined(SYNC_PTR_PMR)
+    /**
+    * \brief Memory resource counting outstanding bytes.
+    */
+    class counting_resource final
+        : public std::pmr::memory_resource
+    {
+    public:
+        size_t  allocated_ = 0;
+
+    private:
+        void * do_allocate(size_t p_bytes, size_t p_align) override
+        {
+            allocated_ += p_bytes;
+            return std::pmr::new_delete_resource()->allocate(p_bytes, p_align);
+        }
+
+        void do_deallocate(void * p_ptr, size_t p_bytes, size_t p_align) override
+        {
+            allocated_ -= p_bytes;
+            std::pmr::new_delete_resource()->deallocate(p_ptr, p_bytes, p_align);
+        }
+
+        bool do_is_equal(std::pmr::memory_resource const & p_other) const noexcept override
+        {
+            return this == &p_other;
+        }
+    };
+#endif // SYNC_PTR_PMR
+
+} // namespace
+
+void tests::cc_sync_ptr_allocate(void)
+{
+    {
+        auto ptr = cc::allocate_sync<std::vector<int>>(std::allocator<int>(), 3U, 7);
+        auto copy(ptr);
+        assert(ptr);
+        assert(ptr->size() == 3U);
+        assert(copy == ptr);
+
+        // Allocated slot is destroyed, chain falls back to separate pointee.
+        bool ret = ptr.reset(new std::vector<int>(1U, 8));
+        assert(ret);
+        assert((*copy)[0] == 8);
+    }
+    {
+        destroyed_count = 0;
+        auto ptr = cc::allocate_sync<std::vector<int>>(destroy_counting_allocator<int>(), 3U, 7);
+
+        // Allocated slot can't leave the chain.
+        std::vector<int> * out = nullptr;
+        bool thrown = false;
+        try
+        {
+            ptr.release(&out);
+        }
+        catch (std::logic_error const &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+        assert(ptr->size() == 3U);
+
+        // It is destroyed through the allocator, separate pointees leave as usual.
+        bool ret = ptr.reset(new std::vector<int>(1U, 8));
+        assert(ret);
+        assert(destroyed_count == 1);
+        ret = ptr.release(&out);
+        assert(ret);
+        delete out;
+        assert(!ptr);
+    }
+
+#if defined(SYNC_PTR_PMR)
+    typedef std::pmr::vector<int> vector_t;
+
+    counting_resource resource;
+    {
+        auto vec = cc::make_sync<vector_t>(&resource, 3U, 7);
+        assert(resource.allocated_ > 0);
+
+        // Uses-allocator pointee draws from the same resource.
+        assert(vec->get_allocator().resource() == &resource);
+        vec->resize(64U);
+        assert((*vec)[63] == 0);
+
+        bool ret = vec.reset(new vector_t(1U, 8));
+        assert(ret);
+        assert(vec->size() == 1U);
+    }
+    assert(resource.allocated_ == 0);
+#endif // SYNC_PTR_PMR
+}
+
+void tests::cc_sync_ptr_empty(void)
+{
+    static int alive = 0;
+    struct Obj
+    {
+        Obj(void) { ++alive; }
+        ~Obj(void) { --alive; }
+    };
+    typedef cc::sync_ptr<Obj> sync_ptr_t;
+
+    // Empty handles are constant initialized.
+    static sync_ptr_t global;
+    assert(!global);
+
+    {
+        sync_ptr_t empty;
+        assert(!empty);
+        assert(empty.get() == nullptr);
+        assert(empty.count() == 0);
+    Obj * raw = nullptr;
+    bool ret = empty.release(&raw);
+    assert(ret);
+    assert(!raw);
+    ret = empty.reset();
+    assert(ret);
+    assert(!empty);
+
+    // First reset gives the empty sync_ptr a chain, earlier copies stay empty.
+    sync_ptr_t copy(empty);
+    ret = empty.reset(new Obj());
+    assert(ret);
+    assert(empty);
+    assert(empty.count() == 1U);
+    assert(!copy);
+
+    ret = copy.exchange(&raw, new Obj());
+    assert(ret);
+    assert(!raw);
+    assert(copy);
+
+        // Moved-from handle is empty.
+        sync_ptr_t moved(std::move(empty));
+        assert(moved.count() == 1U);
+        assert(!empty);
+        assert(empty.count() == 0);
+
+        // Move assignment drops the previous chain.
+        moved = std::move(copy);
+        assert(alive == 1);
+        assert(!copy);
+
+        cc::sync_ref<Obj> ref(empty);
+        assert(!ref);
+        assert(!ref.sync());
+    }
+    assert(alive == 0);
+}
+
+void tests::cc_sync_ptr_weak(void)
+{
+    static std::atomic<int> alive(0);
+    struct Obj
+    {
+        Obj(void) { ++alive; }
+        ~Obj(void) { --alive; }
+    };
+    typedef cc::sync_ptr<Obj> sync_ptr_t;
+    typedef cc::sync_weak_ptr<Obj> sync_weak_ptr_t;
+
+    sync_weak_ptr_t weak;
+    assert(weak.expired());
+    assert(!weak.lock());
+    {
+        sync_ptr_t ptr(new Obj());
+        weak = ptr;
+        assert(!weak.expired());
+        assert(ptr.count() == 1U);
+
+        auto locked = weak.lock();
+        assert(locked == ptr);
+        assert(ptr.count() == 2U);
+
+        // Weak reference follows the chain.
+        bool ret = ptr.reset(new Obj());
+        assert(ret);
+        assert(weak.lock() == ptr);
+        assert(alive == 1);
+    }
+
+    // Pointee goes with the last sync_ptr, the weak reference keeps the body.
+    assert(alive == 0);
+    assert(weak.expired());
+    assert(!weak.lock());
+
+    // Lock racing the last release.
+    for (int i = 0; i < 200; ++i)
+    {
+        auto * ptr = new sync_ptr_t(new Obj());
+        sync_weak_ptr_t observer(*ptr);
+        std::thread release([ptr] { delete ptr; });
+        {
+            auto locked = observer.lock();
+            assert(!locked || alive == 1);
+        }
+        release.join();
+        assert(observer.expired());
+    }
+    assert(alive == 0);
+
+    // Locking a chain emptied by release() doesn't count the missing pointee.
+    {
+        sync_ptr_t ptr(new Obj());
+        sync_weak_ptr_t observer(ptr);
+        Obj * released = nullptr;
+        bool ret = ptr.release(&released);
+        assert(ret);
+        delete released;
+        for (int i = 0; i < 3; ++i)
+        {
+            auto locked = observer.lock();
+            assert(!locked.get());
+            assert(observer.count() == 1U);
+        }
+        ret = ptr.reset(new Obj());
+        assert(ret);
+        assert(observer.lock() == ptr);
+    }
+    assert(alive == 0);
+}
+
+void tests::cc_sync_ptr_array(void)
+{
+    static std::atomic<int> alive(0);
+    struct Obj
+    {
+        int value_;
+        Obj(void) : value_(7) { ++alive; }
+        ~Obj(void) { --alive; }
+    };
+    typedef cc::sync_ptr<Obj[]> sync_ptr_t;
+    {
+        sync_ptr_t ptr = cc::make_sync<Obj[]>(16U);
+        sync_ptr_t copy(ptr);
+        assert(alive == 16);
+        assert(ptr.size() == 16U);
+        assert(ptr[15].value_ == 7);
+        ptr[3].value_ = 3;
+        assert(copy[3].value_ == 3);
+
+        // Copies see the new array and its size.
+        bool ret = ptr.reset(mem::array_block<Obj>::create(4U));
+        assert(ret);
+        assert(alive == 4);
+        assert(copy.size() == 4U);
+        assert(copy[3].value_ == 7);
+        assert(mem::array_block<Obj>::size(copy.get()) == 4U);
+
+        sync_ptr_t empty;
+        assert(empty.size() == 0);
+    }
+    assert(alive == 0);
+
+    // Value vs default initialization of trivial elements.
+    auto zeros = cc::make_sync<double[]>(1024U);
+    assert(zeros.size() == 1024U);
+    for (size_t i = 0; i < zeros.size(); ++i)
+    {
+        assert(zeros[i] == 0.0);
+    }
+    auto buffer = cc::make_sync_for_overwrite<double[]>(1024U);
+    assert(buffer.size() == 1024U);
+    buffer[1023] = 1.0;
+    assert(buffer[1023] == 1.0);
+    auto one = cc::make_sync_for_overwrite<int>();
+    *one = 8;
+    assert(*one == 8);
+
+    // Readers size the array they read while a writer swaps buffers,
+    // retired buffers are kept until the reader is done.
+    std::vector<double (*)[]> buffers;
+    for (size_t n = 1; n < 256U; ++n)
+    {
+        buffers.push_back(mem::array_block<double>::create_for_overwrite(n));
+        for (size_t i = 0; i < n; ++i)
+        {
+            (*buffers.back())[i] = static_cast<double>(n);
+        }
+    }
+    cc::sync_ptr<double[], mem::noop_deleter> swapped(buffers.front());
+    std::atomic<bool> stop(false);
+    std::thread writer([&buffers, &swapped, &stop]
+    {
+        for (size_t i = 1; i < buffers.size(); ++i)
+        {
+            swapped.reset(buffers[i]);
+        }
+        stop = true;
+    });
+    while (!stop)
+    {
+        auto * values = swapped.get();
+        auto size = mem::array_block<double>::size(values);
+        assert((*values)[size - 1U] == static_cast<double>(size));
+    }
+    writer.join();
+    assert(swapped.size() == 255U);
+    for (auto * p : buffers)
+    {
+        mem::array_block<double>::destroy(p);
+    }
+}
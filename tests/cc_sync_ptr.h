@@ -33,6 +33,48 @@ namespace tests
     */
     void cc_sync_ptr_allocator(void);
 
+    /**
+    * \brief Test sync_ptr in place construction.
+    * \note Result: Pointee shares body allocation, reset falls back to separate pointee.
+    */
+    void cc_sync_ptr_inplace(void);
+
+    /**
+    * \brief Test sync_ptr padded body layout.
+    * \note Result: Synchronized on all expected path, counters are spread over cache lines.
+    */
+    void cc_sync_ptr_layout(void);
+
+    /**
+    * \brief Test sync_ref borrowed view.
+    * \note Result: Reads follow the chain without counting, sync() joins the chain.
+    */
+    void cc_sync_ptr_ref(void);
+
+    /**
+    * \brief Test sync_ptr allocator aware construction.
+    * \note Result: Body and pointee come from the allocator or memory resource and are given back to it.
+    */
+    void cc_sync_ptr_allocate(void);
+
+    /**
+    * \brief Test empty and moved-from sync_ptr.
+    * \note Result: Empty sync_ptr allocate nothing, every operation handles them, move assignment frees the old chain.
+    */
+    void cc_sync_ptr_empty(void);
+
+    /**
+    * \brief Test sync_weak_ptr.
+    * \note Result: Weak reference doesn't keep the pointee alive, lock() joins the chain while it is.
+    */
+    void cc_sync_ptr_weak(void);
+
+    /**
+    * \brief Test sync_ptr of array.
+    * \note Result: Elements are indexed through the chain, size follows resets and every element is destroyed.
+    */
+    void cc_sync_ptr_array(void);
+
 } // namespace tests
 
 #endif // __TESTS_CC_SYNC_PTR_H__
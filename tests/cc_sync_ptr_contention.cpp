@@ -0,0 +1,162 @@
+
+// Main header.
+#include "cc_sync_ptr_contention.h"
+
+#include "cc/sync_ptr.h"
+#include "cc/sync_ptr_tagged.h"
+
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    std::atomic<int> alive(0);
+
+    struct counted
+    {
+        counted(
+            void)
+        {
+            alive.fetch_add(1);
+        }
+
+        ~counted(
+            void)
+        {
+            alive.fetch_sub(1);
+        }
+    };
+
+    template<
+        class TPolicy>
+    size_t attempts(
+        TPolicy const & p_policy)
+    {
+        size_t n = 1U;
+        while (p_policy.retry(n - 1U))
+        {
+            ++n;
+        }
+        return n;
+    }
+
+    /**
+    * \brief Writers mixing wait-free and backed off conditional updates on one chain.
+    */
+    template<
+        class TSyncPtr>
+    void concurrent_writers(
+        void)
+    {
+        static constexpr int thread_count = 4;
+        static constexpr int updates = 2000;
+
+        {
+            TSyncPtr ptr(new counted());
+            std::atomic<size_t> failed(0);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < thread_count; ++t)
+            {
+                threads.emplace_back([&ptr, &failed, t]
+                {
+                    TSyncPtr local(ptr);
+                    for (int i = 0; i < updates; ++i)
+                    {
+                        switch ((i + t) % 4)
+                        {
+                        case 0:
+                            local.reset(cc::wait_free, new counted());
+                            break;
+                        case 1:
+                            delete local.exchange(cc::wait_free, new counted());
+                            break;
+                        case 2:
+                        {
+                            auto * p = new counted();
+                            if (!local.reset(p, cc::exponential_backoff()))
+                            {
+                                failed.fetch_add(1U);
+                                delete p;
+                            }
+                            break;
+                        }
+                        default:
+                        {
+                            auto * p = new counted();
+                            counted * out = nullptr;
+                            if (local.exchange(&out, p, cc::yield_retry()))
+                            {
+                                delete out;
+                            }
+                            else
+                            {
+                                failed.fetch_add(1U);
+                                delete p;
+                            }
+                            break;
+                        }
+                        }
+                    }
+                });
+            }
+            for (auto & t : threads)
+            {
+                t.join();
+            }
+            assert(ptr.cas_failures() >= failed.load());
+        }
+        assert(alive.load() == 0);
+    }
+
+} // namespace
+
+
+void tests::cc_sync_ptr_contention_policy(void)
+{
+    assert(attempts(cc::single_attempt()) == 1U);
+    assert(attempts(cc::bounded_retry(5U)) == 5U);
+    assert(attempts(cc::yield_retry(3U)) == 3U);
+    assert(attempts(cc::exponential_backoff(20U, 64U)) == 20U);
+    assert(attempts(cc::bounded_retry(0)) == 1U);
+}
+
+void tests::cc_sync_ptr_contention_writers(void)
+{
+    // Unconditional operations.
+    {
+        cc::sync_ptr<counted> ptr;
+        ptr.reset(cc::wait_free, new counted());
+        cc::sync_ptr<counted> copy(ptr);
+        auto * first = copy.get();
+        auto * second = new counted();
+        assert(ptr.exchange(cc::wait_free, second) == first);
+        delete first;
+        assert(copy.get() == second);
+        assert(copy.release(cc::wait_free) == second);
+        delete second;
+        assert(!ptr);
+        ptr.reset(cc::wait_free, new counted());
+        ptr.reset(cc::wait_free);
+        assert(!copy);
+        assert(ptr.version() == 4U);
+        assert(ptr.cas_failures() == 0);
+
+        // Uncontended conditional operations succeed at the first attempt.
+        assert(ptr.reset(new counted(), cc::bounded_retry(1U)));
+        counted * out = nullptr;
+        assert(ptr.release(&out, cc::single_attempt()));
+        delete out;
+        assert(ptr.cas_failures() == 0);
+
+        cc::sync_ptr<counted> empty;
+        assert(empty.release(cc::wait_free) == nullptr);
+        assert(empty.cas_failures() == 0);
+    }
+    assert(alive.load() == 0);
+
+    concurrent_writers<cc::sync_ptr<counted>>();
+    concurrent_writers<cc::tagged_sync_ptr<counted>>();
+}
@@ -0,0 +1,26 @@
+
+#ifndef __TESTS_CC_SYNC_PTR_CONTENTION_H__
+#define __TESTS_CC_SYNC_PTR_CONTENTION_H__
+
+#ifndef __CC_SYNC_PTR_CONTENTION_H__
+#include "cc/sync_ptr_contention.h"
+#endif
+
+
+namespace tests
+{
+    /**
+    * \brief Test contention policies attempt limits.
+    * \note Result: Each policy allows its number of attempts then gives up.
+    */
+    void cc_sync_ptr_contention_policy(void);
+
+    /**
+    * \brief Test unconditional and policy driven reset, release and exchange under concurrent writers.
+    * \note Result: Wait-free operations always succeed, every pointee is freed once, CAS failures are counted.
+    */
+    void cc_sync_ptr_contention_writers(void);
+
+} // namespace tests
+
+#endif // __TESTS_CC_SYNC_PTR_CONTENTION_H__
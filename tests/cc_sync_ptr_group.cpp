@@ -0,0 +1,88 @@
+
+// Main header.
+#include "cc_sync_ptr_group.h"
+
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <tuple>
+
+
+void tests::cc_sync_ptr_group_commit(void)
+{
+    static std::atomic<int> alive(0);
+
+    struct Model
+    {
+        int generation_;
+        Model(int p_generation = 0) : generation_(p_generation) { ++alive; }
+        ~Model() { --alive; }
+    };
+
+    struct Vocabulary
+    {
+        int generation_;
+        Vocabulary(int p_generation = 0) : generation_(p_generation) { ++alive; }
+        ~Vocabulary() { --alive; }
+    };
+
+    {
+        cc::sync_ptr<Model> model(new Model(0));
+        cc::sync_ptr<Vocabulary> vocabulary(new Vocabulary(0));
+
+        // Uncommitted pointers are freed with the group.
+        {
+            cc::sync_group group;
+            group.stage(model, new Model(-1));
+            group.stage(vocabulary, new Vocabulary(-1));
+            assert(group.size() == 2U);
+            assert(alive == 4);
+        }
+        assert(alive == 2);
+        assert(model->generation_ == 0);
+
+        // Previous pointers are freed on commit.
+        cc::sync_group group;
+        group.stage(model, new Model(1));
+        group.stage(vocabulary, new Vocabulary(1));
+        group.commit();
+        assert(group.size() == 0);
+        assert(alive == 2);
+        assert(model->generation_ == 1);
+        assert(vocabulary->generation_ == 1);
+    }
+    assert(alive == 0);
+
+    // Snapshots racing commits, pointees outlive the chains so readers can't see them freed.
+    static constexpr int generations = 500;
+    static Model models[generations + 1];
+    static Vocabulary vocabularies[generations + 1];
+    {
+        cc::sync_ptr<Model, mem::noop_deleter> model(&models[0]);
+        cc::sync_ptr<Vocabulary, mem::noop_deleter> vocabulary(&vocabularies[0]);
+        std::atomic<bool> done(false);
+
+        std::thread reader([&]
+        {
+            while (!done.load())
+            {
+                auto ptrs = cc::sync_group::snapshot(model, vocabulary);
+                assert(std::get<0>(ptrs) - models == std::get<1>(ptrs) - vocabularies);
+            }
+        });
+
+        for (int i = 1; i <= generations; ++i)
+        {
+            cc::sync_group group;
+            group.stage(vocabulary, &vocabularies[i]);
+            group.stage(model, &models[i]);
+            group.commit();
+        }
+        done.store(true);
+        reader.join();
+
+        auto ptrs = cc::sync_group::snapshot(model, vocabulary);
+        assert(std::get<0>(ptrs) == &models[generations]);
+        assert(std::get<1>(ptrs) == &vocabularies[generations]);
+    }
+}
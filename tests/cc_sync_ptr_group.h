@@ -0,0 +1,20 @@
+
+#ifndef __TESTS_CC_SYNC_PTR_GROUP_H__
+#define __TESTS_CC_SYNC_PTR_GROUP_H__
+
+#ifndef __CC_SYNC_PTR_GROUP_H__
+#include "cc/sync_ptr_group.h"
+#endif
+
+
+namespace tests
+{
+    /**
+    * \brief Test sync_group commit of chains with different pointee types, read by concurrent snapshots.
+    * \note Result: Snapshots never mix generations, previous and uncommitted pointers are freed.
+    */
+    void cc_sync_ptr_group_commit(void);
+
+} // namespace tests
+
+#endif // __TESTS_CC_SYNC_PTR_GROUP_H__
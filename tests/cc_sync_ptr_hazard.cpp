@@ -0,0 +1,107 @@
+
+// Main header.
+#include "cc_sync_ptr_hazard.h"
+
+#include <cassert>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+
+void tests::cc_sync_ptr_hazard_protect(void)
+{
+    static int alive = 0;
+    struct Obj
+    {
+        Obj(void) { ++alive; }
+        ~Obj(void) { --alive; }
+    };
+
+    auto & domain = cc::hazard_domain::instance();
+    domain.reclaim();
+    {
+        cc::hazard_sync_ptr<Obj> ptr(new Obj());
+        assert(alive == 1);
+        {
+            cc::hazard_guard guard;
+            Obj * raw = ptr.get(guard);
+            assert(raw == ptr.get());
+
+            // Retired but protected.
+            ptr.reset(new Obj());
+            domain.reclaim();
+            assert(alive == 2);
+        }
+
+        // No more protected.
+        domain.reclaim();
+        assert(alive == 1);
+    }
+    domain.reclaim();
+    assert(alive == 0);
+
+    // Guards beyond the per-thread slots are rejected.
+    {
+        std::vector<std::unique_ptr<cc::hazard_guard>> guards;
+        for (size_t i = 0; i < cc::hazard_domain::slot_count; ++i)
+        {
+            guards.emplace_back(new cc::hazard_guard());
+        }
+        bool thrown = false;
+        try
+        {
+            cc::hazard_guard extra;
+        }
+        catch (std::length_error const &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+        guards.pop_back();
+        cc::hazard_guard last;
+    }
+}
+
+void tests::cc_sync_ptr_hazard_concurrent(void)
+{
+    struct Obj
+    {
+        std::atomic<int> value_;
+        Obj(int p_value) : value_(p_value) {}
+        ~Obj(void) { value_.store(-1); }
+    };
+
+    cc::hazard_sync_ptr<Obj> ptr(new Obj(0));
+    std::atomic<bool> stop(false);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&ptr, &stop]()
+        {
+            cc::hazard_sync_ptr<Obj> local(ptr);
+            cc::hazard_guard guard;
+            while (!stop.load())
+            {
+                Obj * raw = local.get(guard);
+                assert(raw);
+                assert(raw->value_.load() >= 0);
+                guard.reset();
+            }
+        });
+    }
+
+    for (int i = 1; i < 10000; ++i)
+    {
+        Obj * obj = new Obj(i);
+        while (!ptr.reset(obj))
+        {}
+    }
+    stop.store(true);
+    for (auto & t : readers)
+    {
+        t.join();
+    }
+    cc::hazard_domain::instance().reclaim();
+}
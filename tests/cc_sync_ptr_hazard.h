@@ -0,0 +1,26 @@
+
+#ifndef __TESTS_CC_SYNC_PTR_HAZARD_H__
+#define __TESTS_CC_SYNC_PTR_HAZARD_H__
+
+#ifndef __CC_SYNC_PTR_HAZARD_H__
+#include "cc/sync_ptr_hazard.h"
+#endif
+
+
+namespace tests
+{
+    /**
+    * \brief Test hazard protected get.
+    * \note Result: Retired pointer is freed only once no guard protects it, guards beyond the thread slots throw.
+    */
+    void cc_sync_ptr_hazard_protect(void);
+
+    /**
+    * \brief Test hazard protected get under concurrent reset.
+    * \note Result: Readers never observe a freed pointee.
+    */
+    void cc_sync_ptr_hazard_concurrent(void);
+
+} // namespace tests
+
+#endif // __TESTS_CC_SYNC_PTR_HAZARD_H__
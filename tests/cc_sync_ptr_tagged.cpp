@@ -0,0 +1,153 @@
+
+// Main header.
+#include "cc_sync_ptr_tagged.h"
+
+#include "cc/sync_ptr_hazard.h"
+
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    std::atomic<int> alive(0);
+
+    struct counted
+    {
+        int value_;
+
+        explicit counted(
+            int p_value)
+            : value_(p_value)
+        {
+            alive.fetch_add(1);
+        }
+
+        ~counted(
+            void)
+        {
+            alive.fetch_sub(1);
+        }
+    };
+
+} // namespace
+
+
+void tests::cc_sync_ptr_tagged_aba(void)
+{
+    int a = 0;
+    int b = 0;
+
+    // Plain pointer CAS succeeds on a stale expectation once "a" is back.
+    std::atomic<int *> plain(&a);
+    auto plain_expected = plain.load();
+    plain.exchange(&b);
+    plain.exchange(&a);
+    assert(plain.compare_exchange_strong(plain_expected, &b));
+
+    // Tagged pointer CAS doesn't.
+    cc::tagged_atomic<int> tagged(&a);
+    assert(tagged.load() == &a);
+    assert(tagged.generation() == 0);
+    auto expected = tagged.load_tagged();
+    assert(tagged.exchange(&b) == &a);
+    assert(tagged.exchange(&a) == &b);
+    assert(tagged.generation() == 2U);
+    assert(!tagged.compare_exchange_strong(expected, &b));
+    assert(expected.ptr_ == &a);
+    assert(expected.tag_ == 2U);
+    assert(tagged.compare_exchange_strong(expected, &b));
+    assert(tagged.load() == &b);
+    assert(tagged.generation() == 3U);
+
+    // Chains.
+    {
+        cc::tagged_sync_ptr<counted> ptr(new counted(0));
+        cc::tagged_sync_ptr<counted> copy(ptr);
+        assert(ptr.generation() == 0);
+        assert(ptr.reset(new counted(1)));
+        assert(copy->value_ == 1);
+        assert(copy.generation() == 1U);
+
+        counted * out = nullptr;
+        assert(copy.exchange(&out, new counted(2)));
+        assert(out->value_ == 1);
+        delete out;
+        assert(ptr.release(&out));
+        assert(out->value_ == 2);
+        delete out;
+        assert(!ptr);
+        assert(ptr.generation() == 3U);
+        assert(ptr.version() == 3U);
+
+        assert(ptr.reset(new counted(3)));
+        cc::hazard_guard guard;
+        cc::sync_ptr<counted, cc::hazard_deleter, cc::tagged_body_layout> hazard(new counted(4));
+        assert(hazard.get(guard)->value_ == 4);
+    }
+    cc::hazard_domain::instance().reclaim();
+
+    cc::sync_ptr<int> untagged(new int(0));
+    assert(untagged.reset(new int(1)));
+    assert(untagged.generation() == untagged.version());
+    assert(cc::sync_ptr<int>().generation() == 0);
+
+    assert(alive.load() == 0);
+}
+
+void tests::cc_sync_ptr_tagged_concurrent(void)
+{
+    static constexpr int thread_count = 4;
+    static constexpr int updates = 2000;
+
+    {
+        cc::tagged_sync_ptr<counted> ptr(new counted(0));
+        std::atomic<size_t> succeeded(0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < thread_count; ++t)
+        {
+            threads.emplace_back([&ptr, &succeeded, t]
+            {
+                cc::tagged_sync_ptr<counted> local(ptr);
+                for (int i = 0; i < updates; ++i)
+                {
+                    if (i % 2)
+                    {
+                        auto * p = new counted(t);
+                        if (local.reset(p))
+                        {
+                            succeeded.fetch_add(1U);
+                        }
+                        else
+                        {
+                            delete p;
+                        }
+                    }
+                    else
+                    {
+                        auto * p = new counted(t);
+                        counted * out = nullptr;
+                        if (local.exchange(&out, p))
+                        {
+                            succeeded.fetch_add(1U);
+                            delete out;
+                        }
+                        else
+                        {
+                            delete p;
+                        }
+                    }
+                }
+            });
+        }
+        for (auto & t : threads)
+        {
+            t.join();
+        }
+        assert(succeeded.load() > 0);
+        assert(ptr.generation() == succeeded.load());
+    }
+    assert(alive.load() == 0);
+}
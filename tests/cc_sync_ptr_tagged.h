@@ -0,0 +1,26 @@
+
+#ifndef __TESTS_CC_SYNC_PTR_TAGGED_H__
+#define __TESTS_CC_SYNC_PTR_TAGGED_H__
+
+#ifndef __CC_SYNC_PTR_TAGGED_H__
+#include "cc/sync_ptr_tagged.h"
+#endif
+
+
+namespace tests
+{
+    /**
+    * \brief Test tagged pointer CAS against an expectation read before the same address was published again.
+    * \note Result: Stale expectation fails, generation counts every store.
+    */
+    void cc_sync_ptr_tagged_aba(void);
+
+    /**
+    * \brief Test tagged layout chains under concurrent reset and exchange.
+    * \note Result: Every pointee is freed once, generation matches the successful updates.
+    */
+    void cc_sync_ptr_tagged_concurrent(void);
+
+} // namespace tests
+
+#endif // __TESTS_CC_SYNC_PTR_TAGGED_H__
@@ -0,0 +1,172 @@
+
+// Main header.
+#include "mem_sync_ptr_async.h"
+
+#include "cc/sync_ptr_async.h"
+#include "mem/sync_ptr_async.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    /**
+    * \brief Executor queuing tasks until run() is called.
+    */
+    struct manual_executor
+    {
+        std::vector<std::function<void()>> tasks_;
+
+        void post(
+            std::function<void()> p_task)
+        {
+            tasks_.push_back(std::move(p_task));
+        }
+
+        void run(
+            void)
+        {
+            for (auto & t : tasks_)
+            {
+                t();
+            }
+            tasks_.clear();
+        }
+    };
+
+    /**
+    * \brief Reset a copy of p_ptr asynchronously while readers go through the chain.
+    */
+    template<
+        class TSyncPtr>
+    void reset_async_chain(
+        void)
+    {
+        TSyncPtr ptr(new int(1));
+        TSyncPtr copy(ptr);
+
+        // Nothing is published before the executor runs the factory.
+        manual_executor executor;
+        auto done = reset_async(copy, executor, [] { return new int(2); });
+        assert(*ptr == 1);
+        assert(done.wait_for(std::chrono::seconds(0)) != std::future_status::ready);
+        executor.run();
+        assert(done.get());
+        assert(*ptr == 2);
+        assert(ptr.get() == copy.get());
+
+        // Factory exceptions reach the future, the chain is unchanged.
+        done = reset_async(ptr, executor, []() -> int * { throw std::runtime_error("factory"); });
+        executor.run();
+        bool thrown = false;
+        try
+        {
+            done.get();
+        }
+        catch (std::runtime_error const &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+        assert(*ptr == 2);
+
+        // Built-in pool, readers see the previous pointee while the factory runs.
+        ptr.reset(new int(3));
+        std::atomic<bool> release(false);
+        done = reset_async(ptr, [&release]
+        {
+            while (!release.load())
+            {
+                std::this_thread::yield();
+            }
+            return new int(4);
+        });
+        for (int i = 0; i < 100; ++i)
+        {
+            assert(*copy == 3);
+        }
+        release.store(true);
+        assert(done.get());
+        assert(*copy == 4);
+
+        // The task keeps the chain alive after every handle is gone.
+        std::future<bool> orphan;
+        {
+            TSyncPtr scoped(new int(5));
+            orphan = reset_async(scoped, executor, [] { return new int(6); });
+        }
+        executor.run();
+        assert(orphan.get());
+
+        // A null factory result resets the chain.
+        done = reset_async(ptr, executor, []() -> int * { return nullptr; });
+        executor.run();
+        assert(done.get());
+        assert(!copy);
+
+        // Overlapping calls, the first completion publishes and later ones are stale.
+        TSyncPtr target(new int(7));
+        TSyncPtr target_copy(target);
+        auto first = reset_async(target, executor, [] { return new int(8); });
+        auto second = reset_async(target_copy, executor, [] { return new int(9); });
+        executor.run();
+        assert(first.get());
+        assert(!second.get());
+        assert(*target == 8);
+
+        // A reset after the call makes it stale, the built pointee is freed.
+        done = reset_async(target, executor, [] { return new int(10); });
+        target.reset(new int(11));
+        executor.run();
+        assert(!done.get());
+        assert(*target_copy == 11);
+
+        // Empty sync_ptr can't be reset asynchronously.
+        TSyncPtr empty;
+        thrown = false;
+        try
+        {
+            reset_async(empty, executor, [] { return new int(12); });
+        }
+        catch (std::invalid_argument const &)
+        {
+            thrown = true;
+        }
+        assert(thrown);
+        assert(executor.tasks_.empty());
+    }
+
+} // namespace
+
+
+void tests::mem_sync_ptr_reset_async(void)
+{
+    reset_async_chain<mem::sync_ptr<int>>();
+    reset_async_chain<cc::sync_ptr<int>>();
+
+    mem::async_pool pool(2U);
+    assert(pool.size() == 2U);
+    mem::sync_ptr<int> ptr(new int(0));
+    std::vector<std::future<bool>> pending;
+    for (int i = 1; i <= 16; ++i)
+    {
+        pending.push_back(reset_async(ptr, pool, [i] { return new int(i); }));
+    }
+    int published = 0;
+    for (int i = 1; i <= 16; ++i)
+    {
+        if (pending[i - 1].get())
+        {
+            ++published;
+        }
+    }
+    assert(published >= 1);
+    assert(*ptr >= 1 && *ptr <= 16);
+}
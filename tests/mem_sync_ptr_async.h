@@ -0,0 +1,20 @@
+
+#ifndef __TESTS_MEM_SYNC_PTR_ASYNC_H__
+#define __TESTS_MEM_SYNC_PTR_ASYNC_H__
+
+#ifndef __MEMORY_SYNC_PTR_ASYNC_H__
+#include "mem/sync_ptr_async.h"
+#endif
+
+
+namespace tests
+{
+    /**
+    * \brief Test chains of both flavors reset from factories run on executors.
+    * \note Result: Readers keep the previous pointee until the built one is published, factory exceptions reach the future and stale results are dropped.
+    */
+    void mem_sync_ptr_reset_async(void);
+
+} // namespace tests
+
+#endif // __TESTS_MEM_SYNC_PTR_ASYNC_H__
@@ -0,0 +1,158 @@
+
+// Main header.
+#include "mem_sync_ptr_biased.h"
+
+#include "mem/sync_ptr.h"
+
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    std::atomic<int> biased_deleted(0);
+    std::atomic<int> biased_last(0);
+
+    struct Obj
+    {
+        int value_;
+        Obj(int p_value) : value_(p_value) {}
+        ~Obj() { biased_deleted.fetch_add(1); }
+    };
+
+    typedef mem::sync_ptr<
+        Obj, 
+        mem::default_deleter, 
+        mem::ptr_holder_ts, 
+        mem::biased_ref_counter> sync_ptr_t;
+
+} // namespace
+
+
+void tests::mem_sync_ptr_biased_owner(void)
+{
+    biased_deleted.store(0);
+    {
+        sync_ptr_t ptr1(new Obj(1));
+        {
+            sync_ptr_t ptr2(ptr1);
+            sync_ptr_t ptr3(ptr2);
+            assert(ptr1.count() == 3U);
+            assert(ptr3->value_ == 1);
+        }
+        assert(ptr1.count() == 1U);
+
+        ptr1.reset(new Obj(2));
+        assert(biased_deleted.load() == 1);
+        assert(ptr1->value_ == 2);
+    }
+    assert(biased_deleted.load() == 2);
+}
+
+void tests::mem_sync_ptr_biased_handoff(void)
+{
+    biased_deleted.store(0);
+
+    // Owner alive: release is deferred to its next counting operation.
+    {
+        sync_ptr_t * ptr = new sync_ptr_t(new Obj(1));
+        std::vector<sync_ptr_t> copies(4, *ptr);
+        std::vector<std::thread> threads;
+        for (auto & copy : copies)
+        {
+            threads.emplace_back([&copy]()
+            {
+                sync_ptr_t local(std::move(copy));
+                sync_ptr_t other(local);
+                assert(other->value_ == 1);
+            });
+        }
+        std::thread([ptr]() { delete ptr; }).join();
+        for (auto & t : threads)
+        {
+            t.join();
+        }
+        assert(biased_deleted.load() == 0);
+
+        sync_ptr_t drain(new Obj(2));
+        assert(biased_deleted.load() == 1);
+    }
+    assert(biased_deleted.load() == 2);
+
+    // Owner exited: the last non-owner release merges in place.
+    biased_deleted.store(0);
+    {
+        sync_ptr_t ptr;
+        std::thread([&ptr]()
+        {
+            sync_ptr_t local(new Obj(3));
+            ptr = local;
+        }).join();
+        assert(ptr->value_ == 3);
+        assert(biased_deleted.load() == 0);
+    }
+    assert(biased_deleted.load() == 1);
+}
+
+void tests::mem_sync_ptr_biased_merge_race(void)
+{
+#ifdef SYNC_PTR_TEST_HOOKS
+    biased_last.store(0);
+    {
+        mem::biased_ref_counter counter;
+        std::thread([&counter]() { counter.increment(); }).join();
+
+        // Non-owner drops its shared reference between the owner merge and its return.
+        mem::biased_ref_counter::merged_hook() = [](mem::biased_ref_counter * p_counter)
+        {
+            std::thread([p_counter]()
+            {
+                if (p_counter->decrement() == 1U)
+                {
+                    biased_last.fetch_add(1);
+                }
+            }).join();
+        };
+        if (counter.decrement() == 1U)
+        {
+            biased_last.fetch_add(1);
+        }
+        mem::biased_ref_counter::merged_hook() = nullptr;
+    }
+    assert(biased_last.load() == 1);
+#endif
+}
+
+void tests::mem_sync_ptr_biased_records(void)
+{
+#ifdef SYNC_PTR_TEST_HOOKS
+    biased_deleted.store(0);
+
+    // A record stays pinned while a counter it owns is alive.
+    {
+        std::vector<sync_ptr_t> pinned(64);
+        for (auto & ptr : pinned)
+        {
+            std::thread([&ptr]() { ptr = sync_ptr_t(new Obj(1)); }).join();
+        }
+        assert(mem::biased_ref_counter::record_count() > pinned.size());
+    }
+    assert(biased_deleted.load() == 64);
+
+    // Exited threads records are reused once their counters merged.
+    auto records = mem::biased_ref_counter::record_count();
+    for (int i = 0; i < 64; ++i)
+    {
+        std::thread([i]()
+        {
+            sync_ptr_t ptr(new Obj(i));
+            sync_ptr_t copy(ptr);
+            assert(copy->value_ == i);
+        }).join();
+    }
+    assert(mem::biased_ref_counter::record_count() == records);
+    assert(biased_deleted.load() == 128);
+#endif
+}
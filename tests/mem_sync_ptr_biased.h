@@ -0,0 +1,38 @@
+
+#ifndef __TESTS_MEM_SYNC_PTR_BIASED_H__
+#define __TESTS_MEM_SYNC_PTR_BIASED_H__
+
+#ifndef __MEMORY_SYNC_PTR_BIASED_H__
+#include "mem/sync_ptr_biased.h"
+#endif
+
+
+namespace tests
+{
+    /**
+    * \brief Test biased counter on its owner thread.
+    * \note Result: Counts are exact, pointee is deleted with the last reference.
+    */
+    void mem_sync_ptr_biased_owner(void);
+
+    /**
+    * \brief Test biased counter references dropped by non-owner threads.
+    * \note Result: Pointee is deleted once the owner merges, or at once when the owner exited.
+    */
+    void mem_sync_ptr_biased_handoff(void);
+
+    /**
+    * \brief Test a non-owner release right after the owner merged on its last biased release.
+    * \note Result: Exactly one of both releases reports the last reference.
+    */
+    void mem_sync_ptr_biased_merge_race(void);
+
+    /**
+    * \brief Test owner thread records of exited threads.
+    * \note Result: Records are reused once no counter points to them.
+    */
+    void mem_sync_ptr_biased_records(void);
+
+} // namespace tests
+
+#endif // __TESTS_MEM_SYNC_PTR_BIASED_H__
@@ -0,0 +1,77 @@
+
+// Main header.
+#include "mem_sync_ptr_bravo.h"
+
+#include "mem/sync_ptr.h"
+
+#include <cassert>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+
+void tests::mem_sync_ptr_bravo_synchro(void)
+{
+    struct Obj
+    {
+        int value_;
+        Obj(int p_value) : value_(p_value) {}
+    };
+
+    typedef mem::sync_ptr<Obj, mem::noop_deleter, mem::ptr_holder_bravo> sync_ptr_t;
+
+    static Obj objs[2] = { Obj(0), Obj(1) };
+    sync_ptr_t ptr1(&objs[0]);
+    sync_ptr_t ptr2(ptr1);
+    assert(ptr1 == ptr2);
+
+    ptr1.reset(&objs[1]);
+    assert(ptr2.get() == &objs[1]);
+
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&ptr2, &stop]()
+        {
+            while (!stop.load())
+            {
+                Obj * raw = ptr2.get();
+                assert(raw == &objs[0] || raw == &objs[1]);
+                assert(raw->value_ == (raw == &objs[0] ? 0 : 1));
+            }
+        });
+    }
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        ptr1.reset(&objs[i % 2]);
+    }
+    stop.store(true);
+    for (auto & t : readers)
+    {
+        t.join();
+    }
+}
+
+void tests::mem_sync_ptr_bravo_inhibit(void)
+{
+    int values[2] = { 0, 1 };
+    mem::ptr_holder_bravo<int> holder(&values[0]);
+    assert(holder.biased());
+
+    // Writes leave the bias off, readers restore it once the inhibit deadline passed.
+    assert(holder.set(&values[1]) == &values[0]);
+    assert(!holder.biased());
+    assert(holder.set(&values[0]) == &values[1]);
+    assert(!holder.biased());
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!holder.biased() && std::chrono::steady_clock::now() < deadline)
+    {
+        assert(holder.get() == &values[0]);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    assert(holder.biased());
+    assert(holder.get() == &values[0]);
+}
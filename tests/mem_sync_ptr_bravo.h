@@ -0,0 +1,26 @@
+
+#ifndef __TESTS_MEM_SYNC_PTR_BRAVO_H__
+#define __TESTS_MEM_SYNC_PTR_BRAVO_H__
+
+#ifndef __MEMORY_SYNC_PTR_BRAVO_H__
+#include "mem/sync_ptr_bravo.h"
+#endif
+
+
+namespace tests
+{
+    /**
+    * \brief Test reader-biased holder under concurrent reset.
+    * \note Result: Readers observe every published pointer, chain stays synchronized.
+    */
+    void mem_sync_ptr_bravo_synchro(void);
+
+    /**
+    * \brief Test reader bias inhibition after a write.
+    * \note Result: Bias stays off after set(), a reader restores it past the inhibit deadline.
+    */
+    void mem_sync_ptr_bravo_inhibit(void);
+
+} // namespace tests
+
+#endif // __TESTS_MEM_SYNC_PTR_BRAVO_H__
@@ -0,0 +1,97 @@
+
+// Main header.
+#include "mem_sync_ptr_cached.h"
+
+#include "cc/sync_ptr.h"
+#include "mem/sync_ptr.h"
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <thread>
+
+
+void tests::mem_sync_ptr_cached_version(void)
+{
+    {
+        mem::sync_ptr<int> empty;
+        assert(empty.version() == 0);
+
+        mem::sync_ptr<int> ptr(new int(1));
+        mem::sync_ptr<int> copy(ptr);
+        assert(ptr.version() == 0);
+
+        ptr.reset(new int(2));
+        assert(copy.version() == 1U);
+
+        std::unique_ptr<int> prev(copy.exchange(new int(3)));
+        assert(ptr.version() == 2U);
+
+        std::unique_ptr<int> raw(ptr.release());
+        assert(copy.version() == 3U);
+    }
+    {
+        cc::sync_ptr<int> ptr(new int(1));
+        cc::sync_ptr<int> copy(ptr);
+        assert(ptr.version() == 0);
+
+        bool ret = ptr.reset(new int(2));
+        assert(ret);
+        assert(copy.version() == 1U);
+
+        int * raw = nullptr;
+        ret = copy.exchange(&raw, new int(3));
+        assert(ret);
+        delete raw;
+        assert(ptr.version() == 2U);
+
+        ret = ptr.release(&raw);
+        assert(ret);
+        delete raw;
+        assert(copy.version() == 3U);
+    }
+}
+
+void tests::mem_sync_ptr_cached_reader(void)
+{
+    typedef mem::sync_ptr<int, mem::noop_deleter> sync_ptr_t;
+
+    static constexpr int updates = 1000;
+    static int values[updates + 1];
+    for (int i = 0; i <= updates; ++i)
+    {
+        values[i] = i;
+    }
+
+    sync_ptr_t ptr(&values[0]);
+    {
+        mem::cached_reader<sync_ptr_t> reader(ptr);
+        assert(*reader == 0);
+
+        ptr.reset(&values[1]);
+        assert(reader.get() == &values[1]);
+        assert(reader.chain() == ptr);
+    }
+
+    std::atomic<bool> done(false);
+    std::thread thread([&ptr, &done]
+    {
+        static thread_local mem::cached_reader<sync_ptr_t> reader(ptr);
+        int last = 0;
+        while (!done.load())
+        {
+            // Values only grow, a stale cache would go back.
+            int value = *reader;
+            assert(value >= last);
+            last = value;
+        }
+        assert(*reader == updates);
+    });
+
+    for (int i = 2; i <= updates; ++i)
+    {
+        ptr.reset(&values[i]);
+    }
+    done.store(true);
+    thread.join();
+}
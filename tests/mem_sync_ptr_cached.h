@@ -0,0 +1,26 @@
+
+#ifndef __TESTS_MEM_SYNC_PTR_CACHED_H__
+#define __TESTS_MEM_SYNC_PTR_CACHED_H__
+
+#ifndef __MEMORY_SYNC_PTR_CACHED_H__
+#include "mem/sync_ptr_cached.h"
+#endif
+
+
+namespace tests
+{
+    /**
+    * \brief Test chain version of both flavors.
+    * \note Result: Version is bumped by reset, release and exchange, and shared by the chain.
+    */
+    void mem_sync_ptr_cached_version(void);
+
+    /**
+    * \brief Test cached reader following a chain updated by another thread.
+    * \note Result: Reader returns the cached pointer until the version changes, then the new one.
+    */
+    void mem_sync_ptr_cached_reader(void);
+
+} // namespace tests
+
+#endif // __TESTS_MEM_SYNC_PTR_CACHED_H__
@@ -0,0 +1,114 @@
+
+// Main header.
+#include "mem_sync_ptr_epoch.h"
+
+#include "cc/sync_ptr.h"
+#include "mem/sync_ptr.h"
+
+#include <cassert>
+#include <thread>
+#include <vector>
+
+
+void tests::mem_sync_ptr_epoch_deleter(void)
+{
+    static int alive = 0;
+    struct Obj
+    {
+        Obj(void) { ++alive; }
+        ~Obj(void) { --alive; }
+    };
+    static_assert(
+        !mem::is_immediate_deleter<mem::epoch_deleter<Obj>>::value,
+        "Epoch deleter can't free in place pointees.");
+
+    auto & domain = mem::epoch_domain::instance();
+    {
+        mem::sync_ptr<Obj, mem::epoch_deleter> ptr1(new Obj());
+        cc::sync_ptr<Obj, mem::epoch_deleter> ptr2(new Obj());
+        assert(alive == 2);
+        {
+            mem::epoch_guard guard;
+            Obj * raw1 = ptr1.get();
+            Obj * raw2 = ptr2.get();
+            assert(raw1 && raw2);
+
+            // Retired while a reader is inside the epoch.
+            ptr1.reset(new Obj());
+            ptr2.reset(new Obj());
+            domain.reclaim();
+            domain.reclaim();
+            assert(alive == 4);
+        }
+
+        // Reader left, two epochs later pointers are freed.
+        domain.reclaim();
+        domain.reclaim();
+        domain.reclaim();
+        assert(alive == 2);
+    }
+    domain.reclaim();
+    domain.reclaim();
+    domain.reclaim();
+    assert(alive == 0);
+
+    // Pointers retired by a destructor run from reclaim() wait for a later one.
+    static int nested = 0;
+    struct Nested
+    {
+        ~Nested(void)
+        {
+            if (++nested == 1)
+            {
+                mem::epoch_domain::instance().retire(new Nested());
+            }
+        }
+    };
+    domain.retire(new Nested());
+    for (int i = 0; i < 6; ++i)
+    {
+        domain.reclaim();
+    }
+    assert(nested == 2);
+    assert(domain.pending() == 0);
+}
+
+void tests::mem_sync_ptr_epoch_concurrent(void)
+{
+    struct Obj
+    {
+        std::atomic<int> value_;
+        Obj(int p_value) : value_(p_value) {}
+        ~Obj(void) { value_.store(-1); }
+    };
+
+    mem::sync_ptr<Obj, mem::epoch_deleter> ptr(new Obj(0));
+    std::atomic<bool> stop(false);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 4; ++i)
+    {
+        readers.emplace_back([&ptr, &stop]()
+        {
+            mem::sync_ptr<Obj, mem::epoch_deleter> local(ptr);
+            while (!stop.load())
+            {
+                mem::epoch_guard guard;
+                Obj * raw = local.get();
+                assert(raw);
+                assert(raw->value_.load() >= 0);
+            }
+        });
+    }
+
+    for (int i = 1; i < 10000; ++i)
+    {
+        ptr.reset(new Obj(i));
+    }
+    stop.store(true);
+    for (auto & t : readers)
+    {
+        t.join();
+    }
+    mem::epoch_domain::instance().reclaim();
+}
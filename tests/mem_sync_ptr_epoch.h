@@ -0,0 +1,27 @@
+
+#ifndef __TESTS_MEM_SYNC_PTR_EPOCH_H__
+#define __TESTS_MEM_SYNC_PTR_EPOCH_H__
+
+#ifndef __MEMORY_SYNC_PTR_EPOCH_H__
+#include "mem/sync_ptr_epoch.h"
+#endif
+
+
+namespace tests
+{
+    /**
+    * \brief Test epoch deleter on both sync_ptr flavors.
+    * \note Result: Retired pointer is freed only once every reader left the epoch,
+    * pointers retired while reclaiming are kept for a later reclaim.
+    */
+    void mem_sync_ptr_epoch_deleter(void);
+
+    /**
+    * \brief Test epoch protected get under concurrent reset.
+    * \note Result: Readers never observe a freed pointee.
+    */
+    void mem_sync_ptr_epoch_concurrent(void);
+
+} // namespace tests
+
+#endif // __TESTS_MEM_SYNC_PTR_EPOCH_H__
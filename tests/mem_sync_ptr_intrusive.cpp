@@ -0,0 +1,141 @@
+
+// Main header.
+#include "mem_sync_ptr_intrusive.h"
+
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    std::atomic<int> alive(0);
+
+    struct Node
+    {
+        int                             value_;
+        mem::intrusive_sync_base<Node>  sync_;
+
+        explicit Node(int p_value) : value_(p_value) { ++alive; }
+        ~Node(void) { --alive; }
+    };
+
+} // namespace
+
+
+namespace mem
+{
+    template<>
+    struct intrusive_sync_hook<Node>
+    {
+        static inline intrusive_sync_base<Node> & state(
+            Node * p_ptr)
+            noexcept
+        {
+            return p_ptr->sync_;
+        }
+    };
+
+} // namespace mem
+
+
+void tests::mem_sync_ptr_intrusive_chain(void)
+{
+    static std::atomic<int> created(0);
+    struct Obj
+        : public mem::intrusive_sync_base<Obj>
+    {
+        int value_;
+        explicit Obj(int p_value) : value_(p_value) { ++created; }
+        Obj(Obj const & p_other) : mem::intrusive_sync_base<Obj>(p_other), value_(p_other.value_) { ++created; }
+        ~Obj(void) { --created; }
+    };
+    typedef mem::intrusive_sync_ptr<Obj> sync_ptr_t;
+
+    // A chain is one pointer wide.
+    static_assert(sizeof(sync_ptr_t) == sizeof(Obj *), "intrusive_sync_ptr is a single pointer.");
+
+    sync_ptr_t empty;
+    assert(!empty);
+    assert(empty.count() == 0);
+    {
+        auto ptr = mem::make_intrusive_sync<Obj>(1);
+        auto * root = ptr.get();
+        sync_ptr_t copy(ptr);
+        assert(copy == ptr);
+        assert(ptr.count() == 2U);
+        assert(copy->value_ == 1);
+
+        // Copies follow, the root stays until the chain goes.
+        ptr.reset(new Obj(2));
+        assert(copy->value_ == 2);
+        assert(created == 2);
+
+        // Replaced pointees other than the root are freed at once.
+        copy.reset(new Obj(3));
+        assert(ptr->value_ == 3);
+        assert(created == 2);
+
+        // The root can be published again.
+        copy.reset(root);
+        assert(ptr.get() == root);
+        assert(created == 1);
+
+        ptr.reset();
+        assert(!copy);
+        assert(copy.count() == 2U);
+        assert(created == 1);
+
+        // Copying the pointee doesn't copy the chain.
+        Obj clone(*root);
+        sync_ptr_t other(new Obj(clone));
+        assert(other.count() == 1U);
+
+        sync_ptr_t moved(std::move(other));
+        assert(!other);
+        assert(moved.count() == 1U);
+        empty = moved;
+        assert(moved.count() == 2U);
+        empty = sync_ptr_t();
+        assert(moved.count() == 1U);
+    }
+    assert(created == 0);
+
+    // An empty intrusive_sync_ptr gets a chain of its own.
+    empty.reset(new Obj(4));
+    assert(empty->value_ == 4);
+    assert(empty.count() == 1U);
+    empty = sync_ptr_t();
+    assert(created == 0);
+}
+
+void tests::mem_sync_ptr_intrusive_hook(void)
+{
+    typedef mem::intrusive_sync_ptr<Node> sync_ptr_t;
+    {
+        sync_ptr_t ptr(new Node(1));
+        ptr.reset(new Node(2));
+        assert(ptr->value_ == 2);
+        assert(alive == 2);
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 4; ++i)
+        {
+            threads.emplace_back([ptr]()
+            {
+                for (int n = 0; n < 10000; ++n)
+                {
+                    sync_ptr_t copy(ptr);
+                    assert(copy.count() >= 2U);
+                }
+            });
+        }
+        for (auto & t : threads)
+        {
+            t.join();
+        }
+        assert(ptr.count() == 1U);
+    }
+    assert(alive == 0);
+}
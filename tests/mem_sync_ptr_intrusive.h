@@ -0,0 +1,26 @@
+
+#ifndef __TESTS_MEM_SYNC_PTR_INTRUSIVE_H__
+#define __TESTS_MEM_SYNC_PTR_INTRUSIVE_H__
+
+#ifndef __MEMORY_SYNC_PTR_INTRUSIVE_H__
+#include "mem/sync_ptr_intrusive.h"
+#endif
+
+
+namespace tests
+{
+    /**
+    * \brief Test intrusive chain copies, resets and destruction.
+    * \note Result: Copies follow resets, replaced pointees are freed at once, the root with the last copy.
+    */
+    void mem_sync_ptr_intrusive_chain(void);
+
+    /**
+    * \brief Test intrusive chain state held as a member through intrusive_sync_hook.
+    * \note Result: Same behavior as a derived pointee, concurrent copies keep the count exact.
+    */
+    void mem_sync_ptr_intrusive_hook(void);
+
+} // namespace tests
+
+#endif // __TESTS_MEM_SYNC_PTR_INTRUSIVE_H__
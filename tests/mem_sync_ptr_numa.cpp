@@ -0,0 +1,97 @@
+
+// Main header.
+#include "mem_sync_ptr_numa.h"
+
+#include <atomic>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+
+
+void tests::mem_sync_ptr_numa_topology(void)
+{
+    typedef std::vector<int> ids_t;
+
+    assert(mem::numa_topology::parse_cpulist("0") == ids_t({ 0 }));
+    assert(mem::numa_topology::parse_cpulist("0-3,8,10-11\n") == ids_t({ 0, 1, 2, 3, 8, 10, 11 }));
+    assert(mem::numa_topology::parse_cpulist("").empty());
+
+    auto const & topology = mem::numa_topology::instance();
+    assert(topology.node_count() >= 1U);
+    assert(topology.current_node() < topology.node_count());
+    if (topology.node_count() == 1U)
+    {
+        assert(topology.cpus(0).empty());
+    }
+    for (size_t n = 0; n < topology.node_count() && topology.node_count() > 1U; ++n)
+    {
+        assert(!topology.cpus(n).empty());
+    }
+}
+
+void tests::mem_sync_ptr_numa_replicas(void)
+{
+    typedef mem::numa_sync_ptr<std::string> numa_ptr_t;
+
+    auto const & topology = mem::numa_topology::instance();
+
+    numa_ptr_t empty;
+    assert(!empty);
+    assert(empty.get() == nullptr);
+    assert(empty.replicas() == 0);
+
+    auto * raw = new std::string("rules v1");
+    numa_ptr_t ptr(raw);
+    numa_ptr_t copy(ptr);
+    assert(ptr.replicas() == topology.node_count());
+    for (size_t n = 0; n < ptr.replicas(); ++n)
+    {
+        assert(*ptr.get(n) == "rules v1");
+    }
+    if (ptr.replicas() == 1U)
+    {
+        assert(ptr.get() == raw);
+    }
+
+    // Resets replace every replica of every copy.
+    auto v = copy.version();
+    copy.reset(new std::string("rules v2"));
+    assert(ptr.version() != v);
+    assert(*ptr == "rules v2");
+    assert(ptr->size() == 8U);
+    for (size_t n = 0; n < ptr.replicas(); ++n)
+    {
+        assert(*copy.get(n) == "rules v2");
+    }
+
+    copy.emplace(3U, 'x');
+    assert(*ptr == "xxx");
+    assert(ptr.count() == 2U);
+
+    // Readers on other threads see a replica of their node, a guarded read survives concurrent resets.
+    std::atomic<bool> stop(false);
+    std::thread reader([&ptr, &stop]
+    {
+        while (!stop.load())
+        {
+            mem::rcu_read_guard guard;
+            auto * replica = ptr.get();
+            assert(replica && replica->size() == 3U);
+        }
+    });
+    for (char c = 'a'; c <= 'z'; ++c)
+    {
+        copy.emplace(3U, c);
+    }
+    stop.store(true);
+    reader.join();
+    assert(*ptr == "zzz");
+
+    // Any lock-free holder may be used.
+    mem::numa_sync_ptr<std::string, mem::epoch_deleter, mem::ptr_holder_rcu_deferred> deferred(new std::string("v"));
+    assert(*deferred == "v");
+
+    ptr.reset();
+    assert(!copy);
+}
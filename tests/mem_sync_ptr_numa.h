@@ -0,0 +1,26 @@
+
+#ifndef __TESTS_MEM_SYNC_PTR_NUMA_H__
+#define __TESTS_MEM_SYNC_PTR_NUMA_H__
+
+#ifndef __MEMORY_SYNC_PTR_NUMA_H__
+#include "mem/sync_ptr_numa.h"
+#endif
+
+
+namespace tests
+{
+    /**
+    * \brief Test /sys node and cpu list parsing and topology lookup.
+    * \note Result: Lists expand to ids, the current node is one of the known nodes.
+    */
+    void mem_sync_ptr_numa_topology(void);
+
+    /**
+    * \brief Test replicated chains reset, emplaced and shared across copies.
+    * \note Result: One equal replica per node, get() returns the local one without locking.
+    */
+    void mem_sync_ptr_numa_replicas(void);
+
+} // namespace tests
+
+#endif // __TESTS_MEM_SYNC_PTR_NUMA_H__
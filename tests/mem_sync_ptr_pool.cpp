@@ -0,0 +1,188 @@
+
+// Main header.
+#include "mem_sync_ptr_pool.h"
+
+#include <cassert>
+#include <set>
+#include <thread>
+#include <vector>
+
+
+void tests::mem_sync_ptr_pool_reuse(void)
+{
+    struct Block
+    {
+        size_t values_[4];
+    };
+
+    typedef mem::body_pool<Block> pool_t;
+    auto & pool = pool_t::instance();
+
+    std::vector<void *> blocks;
+    for (size_t i = 0; i < pool_t::slab_size; ++i)
+    {
+        blocks.push_back(pool.allocate());
+    }
+    auto stats = pool.stats();
+    assert(stats.misses_ == 1U);
+    assert(stats.slabs_ == 1U);
+    assert(stats.hits_ == pool_t::slab_size - 1U);
+
+    std::set<void *> addresses(blocks.begin(), blocks.end());
+    assert(addresses.size() == blocks.size());
+
+    for (auto * p : blocks)
+    {
+        pool.deallocate(p);
+    }
+    for (size_t i = 0; i < pool_t::slab_size; ++i)
+    {
+        auto * p = pool.allocate();
+        assert(addresses.count(p) == 1U);
+        pool.deallocate(p);
+    }
+
+    stats = pool.stats();
+    assert(stats.misses_ == 1U);
+    assert(stats.slabs_ == 1U);
+    assert(stats.hit_rate() > 0.9);
+}
+
+void tests::mem_sync_ptr_pool_threads(void)
+{
+    struct Block
+    {
+        size_t values_[2];
+    };
+
+    typedef mem::body_pool<Block> pool_t;
+    auto & pool = pool_t::instance();
+
+    // Blocks allocated here are freed by worker threads.
+    const size_t count = 4U * pool_t::magazine_size;
+    std::vector<std::vector<void *>> batches(4);
+    for (auto & batch : batches)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            batch.push_back(pool.allocate());
+        }
+    }
+    auto slabs = pool.stats().slabs_;
+
+    std::vector<std::thread> threads;
+    for (auto & batch : batches)
+    {
+        threads.emplace_back([&pool, &batch]()
+        {
+            for (auto * p : batch)
+            {
+                pool.deallocate(p);
+            }
+        });
+    }
+    for (auto & t : threads)
+    {
+        t.join();
+    }
+
+    // Exited threads gave their magazines back, no new slab is needed.
+    for (auto & batch : batches)
+    {
+        for (auto & p : batch)
+        {
+            p = pool.allocate();
+        }
+    }
+    assert(pool.stats().slabs_ == slabs);
+
+    for (auto & batch : batches)
+    {
+        for (auto * p : batch)
+        {
+            pool.deallocate(p);
+        }
+    }
+
+    // Concurrent depot traffic never hands a block out twice.
+    threads.clear();
+    for (size_t t = 0; t < 4U; ++t)
+    {
+        threads.emplace_back([&pool, t]()
+        {
+            std::vector<Block *> held;
+            for (size_t round = 0; round < 200U; ++round)
+            {
+                for (size_t i = 0; i < 3U * pool_t::magazine_size; ++i)
+                {
+                    auto * b = static_cast<Block *>(pool.allocate());
+                    b->values_[0] = t;
+                    b->values_[1] = i;
+                    held.push_back(b);
+                }
+                for (size_t i = 0; i < held.size(); ++i)
+                {
+                    assert(held[i]->values_[0] == t && held[i]->values_[1] == i);
+                    pool.deallocate(held[i]);
+                }
+                held.clear();
+            }
+        });
+    }
+    for (auto & t : threads)
+    {
+        t.join();
+    }
+}
+
+namespace
+{
+    struct exit_block
+    {
+        size_t values_[3];
+    };
+
+    typedef mem::body_pool<exit_block> exit_pool_t;
+
+    /**
+    * \brief Constructed before the thread magazines, so destroyed after them.
+    */
+    struct exit_holder
+    {
+        void * block_;
+
+        exit_holder(void) : block_(nullptr) {}
+
+        ~exit_holder(void)
+        {
+            auto & pool = exit_pool_t::instance();
+            pool.deallocate(block_);
+            pool.deallocate(pool.allocate());
+        }
+    };
+
+} // namespace
+
+void tests::mem_sync_ptr_pool_thread_exit(void)
+{
+    auto & pool = exit_pool_t::instance();
+
+    std::thread([&pool]()
+    {
+        static thread_local exit_holder holder;
+        holder.block_ = pool.allocate();
+    }).join();
+
+    // The late free went to a depot, no new slab is needed.
+    auto slabs = pool.stats().slabs_;
+    std::vector<void *> blocks;
+    for (size_t i = 0; i < exit_pool_t::slab_size; ++i)
+    {
+        blocks.push_back(pool.allocate());
+    }
+    assert(pool.stats().slabs_ == slabs);
+    for (auto * p : blocks)
+    {
+        pool.deallocate(p);
+    }
+}
@@ -0,0 +1,33 @@
+
+#ifndef __TESTS_MEM_SYNC_PTR_POOL_H__
+#define __TESTS_MEM_SYNC_PTR_POOL_H__
+
+#ifndef __MEMORY_SYNC_PTR_POOL_H__
+#include "mem/sync_ptr_pool.h"
+#endif
+
+
+namespace tests
+{
+    /**
+    * \brief Test body pool block reuse on a single thread.
+    * \note Result: Freed blocks are handed out again, only the first allocation misses.
+    */
+    void mem_sync_ptr_pool_reuse(void);
+
+    /**
+    * \brief Test body pool with blocks freed by other threads.
+    * \note Result: Magazines travel through the depots, exited threads give theirs back,
+    * concurrent depot pops never hand a block out twice.
+    */
+    void mem_sync_ptr_pool_threads(void);
+
+    /**
+    * \brief Test body pool used by thread_local objects destroyed after the thread magazines.
+    * \note Result: Late frees and allocations go through the depots, blocks are reused.
+    */
+    void mem_sync_ptr_pool_thread_exit(void);
+
+} // namespace tests
+
+#endif // __TESTS_MEM_SYNC_PTR_POOL_H__
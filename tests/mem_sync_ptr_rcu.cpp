@@ -0,0 +1,112 @@
+
+// Main header.
+#include "mem_sync_ptr_rcu.h"
+
+#include "mem/sync_ptr.h"
+
+#include <cassert>
+#include <chrono>
+#include <thread>
+
+
+void tests::mem_sync_ptr_rcu_grace(void)
+{
+    static std::atomic<bool> reader_left(false);
+    struct Obj
+    {
+        ~Obj(void) { assert(reader_left.load()); }
+    };
+
+    mem::sync_ptr<Obj, mem::default_deleter, mem::ptr_holder_rcu> ptr(new Obj());
+    std::atomic<bool> reader_in(false);
+
+    std::thread reader([&ptr, &reader_in]()
+    {
+        mem::rcu_read_guard guard;
+        Obj * raw = ptr.get();
+        assert(raw);
+        reader_in.store(true);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        reader_left.store(true);
+    });
+
+    while (!reader_in.load())
+    {
+        std::this_thread::yield();
+    }
+
+    // Waits for the reader.
+    ptr.reset(new Obj());
+    assert(reader_left.load());
+    reader.join();
+}
+
+void tests::mem_sync_ptr_rcu_deferred(void)
+{
+    static int alive = 0;
+    struct Obj
+    {
+        Obj(void) { ++alive; }
+        ~Obj(void) { --alive; }
+    };
+
+    auto & domain = mem::epoch_domain::instance();
+    {
+        mem::sync_ptr<Obj, mem::epoch_deleter, mem::ptr_holder_rcu_deferred> ptr(new Obj());
+        {
+            mem::rcu_read_guard guard;
+            Obj * raw = ptr.get();
+            assert(raw);
+
+            // Does not wait, pointer is retired.
+            ptr.reset(new Obj());
+            domain.reclaim();
+            domain.reclaim();
+            assert(alive == 2);
+        }
+        domain.reclaim();
+        domain.reclaim();
+        domain.reclaim();
+        assert(alive == 1);
+    }
+    domain.reclaim();
+    domain.reclaim();
+    domain.reclaim();
+    assert(alive == 0);
+}
+
+void tests::mem_sync_ptr_rcu_in_section(void)
+{
+    static int alive = 0;
+    struct Obj
+    {
+        Obj(void) { ++alive; }
+        Obj(Obj &&) { ++alive; }
+        ~Obj(void) { --alive; }
+    };
+    typedef mem::sync_ptr<Obj, mem::default_deleter, mem::ptr_holder_rcu> sync_ptr_t;
+
+    auto & domain = mem::epoch_domain::instance();
+    {
+        sync_ptr_t ptr(new Obj());
+        sync_ptr_t inplace = mem::make_sync_inplace<Obj, mem::default_deleter, mem::ptr_holder_rcu>();
+        {
+            mem::rcu_read_guard guard;
+            Obj * raw = ptr.get();
+            Obj * raw_inplace = inplace.get();
+            assert(raw && raw_inplace);
+
+            // Retired instead of waiting for this very section.
+            ptr.reset(new Obj());
+            inplace = sync_ptr_t();
+            domain.reclaim();
+            domain.reclaim();
+            assert(alive == 3);
+        }
+        domain.reclaim();
+        domain.reclaim();
+        domain.reclaim();
+        assert(alive == 1);
+    }
+    assert(alive == 0);
+}
@@ -0,0 +1,32 @@
+
+#ifndef __TESTS_MEM_SYNC_PTR_RCU_H__
+#define __TESTS_MEM_SYNC_PTR_RCU_H__
+
+#ifndef __MEMORY_SYNC_PTR_RCU_H__
+#include "mem/sync_ptr_rcu.h"
+#endif
+
+
+namespace tests
+{
+    /**
+    * \brief Test RCU holder grace period.
+    * \note Result: Previous pointer is freed after the reader left its section.
+    */
+    void mem_sync_ptr_rcu_grace(void);
+
+    /**
+    * \brief Test deferred RCU holder with epoch deleter.
+    * \note Result: Reset returns immediately, previous pointer is freed after the reader left.
+    */
+    void mem_sync_ptr_rcu_deferred(void);
+
+    /**
+    * \brief Test waiting RCU holder reset and released from inside a read-side section.
+    * \note Result: No self-deadlock, previous pointees are freed after the section ends.
+    */
+    void mem_sync_ptr_rcu_in_section(void);
+
+} // namespace tests
+
+#endif // __TESTS_MEM_SYNC_PTR_RCU_H__
@@ -0,0 +1,166 @@
+
+// Main header.
+#include "mem_sync_ptr_reclaim.h"
+
+#include "cc/sync_ptr.h"
+#include "mem/sync_ptr.h"
+
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+
+namespace
+{
+    std::atomic<size_t> destroyed(0);
+    std::atomic<size_t> destroyed_inline(0);
+    std::thread::id resetting_thread;
+
+    /**
+    * \brief Pointee counting destructions run on the resetting thread.
+    */
+    struct heavy
+    {
+        char payload_[256];
+
+        ~heavy(
+            void)
+        {
+            destroyed.fetch_add(1U);
+            if (std::this_thread::get_id() == resetting_thread)
+            {
+                destroyed_inline.fetch_add(1U);
+            }
+        }
+    };
+
+    /**
+    * \brief Pointee flushing the reclaimer from its destructor.
+    */
+    struct flushing
+    {
+        ~flushing(
+            void)
+        {
+            mem::reclaimer::instance().flush();
+            destroyed.fetch_add(1U);
+        }
+    };
+
+    template<
+        class TSyncPtr>
+    void reclaim_chain(
+        size_t p_resets)
+    {
+        auto & r = mem::reclaimer::instance();
+        auto before = r.stats();
+        destroyed.store(0);
+        destroyed_inline.store(0);
+        resetting_thread = std::this_thread::get_id();
+
+        {
+            TSyncPtr ptr(new heavy());
+            TSyncPtr copy(ptr);
+            for (size_t i = 0; i < p_resets; ++i)
+            {
+                copy.reset(new heavy());
+            }
+        }
+        r.flush();
+
+        auto after = r.stats();
+        assert(destroyed.load() == p_resets + 1U);
+        assert(destroyed_inline.load() == 0);
+        assert(after.retired_ - before.retired_ == p_resets + 1U);
+        assert(after.reclaimed_ - before.reclaimed_ == p_resets + 1U);
+        assert(after.batches_ > before.batches_);
+        assert(after.queue_depth_ == 0);
+        assert(after.queue_bytes_ == 0);
+    }
+
+} // namespace
+
+
+void tests::mem_sync_ptr_reclaim_background(void)
+{
+    typedef mem::sync_ptr<heavy, mem::reclaim_deleter> mem_sync_ptr_t;
+    typedef cc::sync_ptr<heavy, mem::reclaim_deleter> cc_sync_ptr_t;
+
+    auto & r = mem::reclaimer::instance();
+    r.set_batch_size(16U);
+    assert(r.batch_size() == 16U);
+
+    reclaim_chain<mem_sync_ptr_t>(200U);
+    reclaim_chain<cc_sync_ptr_t>(200U);
+
+    // Partial batches wait for the next full batch or flush().
+    destroyed.store(0);
+    {
+        mem_sync_ptr_t ptr(new heavy());
+        ptr.reset(new heavy());
+        assert(r.stats().queue_depth_ >= 1U);
+        assert(r.stats().queue_bytes_ >= sizeof(heavy));
+    }
+    r.flush();
+    assert(destroyed.load() == 2U);
+
+    // Batches of exited threads are handed over.
+    destroyed.store(0);
+    {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([]
+            {
+                mem_sync_ptr_t ptr(new heavy());
+                for (int i = 0; i < 10; ++i)
+                {
+                    ptr.reset(new heavy());
+                }
+            });
+        }
+        for (auto & t : threads)
+        {
+            t.join();
+        }
+    }
+    r.flush();
+    assert(destroyed.load() == 44U);
+
+    // Over budget, the resetting thread frees inline.
+    auto inline_before = r.stats().inline_;
+    r.set_budget(0);
+    destroyed.store(0);
+    destroyed_inline.store(0);
+    {
+        mem_sync_ptr_t ptr(new heavy());
+        ptr.reset(new heavy());
+        assert(destroyed_inline.load() == 1U);
+    }
+    assert(destroyed_inline.load() == 2U);
+    assert(r.stats().inline_ - inline_before == 2U);
+    r.set_budget(mem::reclaimer::default_budget);
+
+    auto stats = r.stats();
+    assert(stats.latency_max_ >= stats.latency_avg());
+
+    // Destructors run by the reclaimer thread may flush without waiting on themselves.
+    r.set_batch_size(1U);
+    destroyed.store(0);
+    {
+        mem::sync_ptr<flushing, mem::reclaim_deleter> ptr(new flushing());
+        ptr.reset(new flushing());
+    }
+    r.flush();
+    assert(destroyed.load() == 2U);
+    r.set_batch_size(16U);
+
+    // Shut down, later retires free inline.
+    r.shutdown();
+    destroyed_inline.store(0);
+    {
+        cc_sync_ptr_t ptr(new heavy());
+    }
+    assert(destroyed_inline.load() == 1U);
+}
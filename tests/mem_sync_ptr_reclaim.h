@@ -0,0 +1,20 @@
+
+#ifndef __TESTS_MEM_SYNC_PTR_RECLAIM_H__
+#define __TESTS_MEM_SYNC_PTR_RECLAIM_H__
+
+#ifndef __MEMORY_SYNC_PTR_RECLAIM_H__
+#include "mem/sync_ptr_reclaim.h"
+#endif
+
+
+namespace tests
+{
+    /**
+    * \brief Test chains of both flavors freeing previous pointees through the background reclaimer.
+    * \note Result: Pointees are destroyed off the resetting thread, inline once over budget or shut down.
+    */
+    void mem_sync_ptr_reclaim_background(void);
+
+} // namespace tests
+
+#endif // __TESTS_MEM_SYNC_PTR_RECLAIM_H__
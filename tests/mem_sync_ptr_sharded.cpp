@@ -0,0 +1,82 @@
+
+// Main header.
+#include "mem_sync_ptr_sharded.h"
+
+#include "mem/sync_ptr.h"
+
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+
+void tests::mem_sync_ptr_sharded_release(void)
+{
+    static_assert(
+        sizeof(mem::basic_sharded_ref_counter<4U>) == (4U + 2U) * 2U * mem::cache_line_size,
+        "Each count takes a pad line, a root line and one line per slot.");
+
+    static std::atomic<int> deleted(0);
+
+    struct Obj
+    {
+        int value_;
+        Obj(int p_value) : value_(p_value) {}
+        ~Obj() { deleted.fetch_add(1); }
+    };
+
+    typedef mem::sync_ptr<
+        Obj,
+        mem::default_deleter,
+        mem::ptr_holder_ts,
+        mem::sharded_ref_counter> sync_ptr_t;
+
+    {
+        sync_ptr_t ptr(new Obj(1));
+        sync_ptr_t copy(ptr);
+        assert(ptr.count() == 2U);
+    }
+    assert(deleted.load() == 1);
+
+    deleted.store(0);
+    for (int round = 0; round < 16; ++round)
+    {
+        // Every thread drops the copies taken by its neighbour.
+        const size_t thread_count = 8U;
+        std::vector<std::vector<sync_ptr_t>> copies(thread_count);
+        {
+            sync_ptr_t ptr(new Obj(round));
+            std::vector<std::thread> threads;
+            for (size_t i = 0; i < thread_count; ++i)
+            {
+                threads.emplace_back([&ptr, &copies, i]()
+                {
+                    for (int j = 0; j < 100; ++j)
+                    {
+                        copies[i].emplace_back(ptr);
+                    }
+                });
+            }
+            for (auto & t : threads)
+            {
+                t.join();
+            }
+            threads.clear();
+
+            for (size_t i = 0; i < thread_count; ++i)
+            {
+                threads.emplace_back([&copies, i, thread_count]()
+                {
+                    copies[(i + 1U) % thread_count].clear();
+                });
+            }
+            for (auto & t : threads)
+            {
+                t.join();
+            }
+            assert(ptr.count() == 1U);
+            assert(deleted.load() == round);
+        }
+        assert(deleted.load() == round + 1);
+    }
+}
@@ -0,0 +1,20 @@
+
+#ifndef __TESTS_MEM_SYNC_PTR_SHARDED_H__
+#define __TESTS_MEM_SYNC_PTR_SHARDED_H__
+
+#ifndef __MEMORY_SYNC_PTR_SHARDED_H__
+#include "mem/sync_ptr_sharded.h"
+#endif
+
+
+namespace tests
+{
+    /**
+    * \brief Test sharded counter with references taken and dropped by different threads.
+    * \note Result: Pointee and body are released exactly once, with the last reference.
+    */
+    void mem_sync_ptr_sharded_release(void);
+
+} // namespace tests
+
+#endif // __TESTS_MEM_SYNC_PTR_SHARDED_H__
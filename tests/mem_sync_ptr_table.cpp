@@ -0,0 +1,195 @@
+
+// Main header.
+#include "mem_sync_ptr_table.h"
+
+#include <cassert>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+void tests::mem_sync_ptr_table_handles(void)
+{
+    static std::atomic<int> alive(0);
+    struct Obj
+    {
+        int value_;
+        explicit Obj(int p_value) : value_(p_value) { ++alive; }
+        ~Obj(void) { --alive; }
+    };
+    typedef mem::sync_table<Obj> table_t;
+    typedef table_t::handle_type handle_t;
+    // 4 generation bits.
+    typedef mem::sync_table<
+        Obj,
+        mem::sync_ptr_deleter,
+        mem::sync_ptr_holder,
+        mem::sync_ptr_ref_counter,
+        28U> short_table_t;
+    typedef short_table_t::handle_type short_handle_t;
+
+    static_assert(sizeof(handle_t) == sizeof(std::uint32_t), "Handles are 32 bits.");
+
+    table_t table;
+    handle_t null;
+    assert(!null);
+    assert(!table.valid(null));
+    assert(!table.get(null));
+    {
+        auto h = table.create(new Obj(1));
+        assert(h);
+        assert(table.valid(h));
+        assert(table.get(h)->value_ == 1);
+        assert(table.count(h) == 1U);
+        assert(table.size() == 1U);
+
+        // A copy is the same 32 bits value, counted with retain().
+        auto copy = handle_t::from_value(h.value());
+        assert(copy == h);
+        table.retain(copy);
+        assert(table.count(h) == 2U);
+
+        // Every handle sees the new pointee.
+        table.reset(h, new Obj(2));
+        assert(table.get(copy)->value_ == 2);
+        assert(alive == 1);
+
+        table.reset(copy);
+        assert(!table.get(h));
+        assert(table.valid(h));
+        assert(alive == 0);
+        table.reset(copy, new Obj(3));
+
+        table.release(copy);
+        assert(table.valid(h));
+        assert(alive == 1);
+        table.release(h);
+        assert(alive == 0);
+        assert(table.size() == 0);
+
+        // Stale handle.
+        assert(!table.valid(h));
+        assert(!table.get(h));
+        assert(table.count(h) == 0);
+        assert(!table.retain(h));
+        assert(!table.release(h));
+        assert(!table.reset(h, new Obj(4)));
+        assert(alive == 0);
+
+        // Freed slots are reused oldest first.
+        auto next = table.emplace(5);
+        assert(next.index() != h.index());
+        table.release(next);
+    }
+
+    // Chains created in a row on a fresh table are neighbors.
+    {
+        table_t fresh;
+        std::vector<handle_t> handles;
+        for (int i = 0; i < 5000; ++i)
+        {
+            handles.push_back(fresh.emplace(i));
+        }
+        for (size_t i = 1; i < handles.size(); ++i)
+        {
+            assert(handles[i].index() == handles[i - 1U].index() + 1U);
+        }
+        assert(alive == 5000);
+        assert(fresh.size() == 5000U);
+        for (auto h : handles)
+        {
+            assert(fresh.release(h));
+        }
+        assert(alive == 0);
+    }
+
+    // Stale handles are rejected once their slot is reused, generations skip 0 when they wrap around.
+    {
+        short_table_t short_table;
+        std::vector<short_handle_t> others;
+        for (size_t i = 1; i < short_table_t::chunk_size; ++i)
+        {
+            others.push_back(short_table.emplace(0));
+        }
+
+        // One free slot left, every chain reuses it.
+        auto h = short_table.emplace(0);
+        auto index = h.index();
+        for (int i = 0; i < 40; ++i)
+        {
+            auto stale = h;
+            short_table.release(h);
+            h = short_table.emplace(i);
+            assert(h.index() == index);
+            assert(h);
+            assert(h != stale);
+            assert(!short_table.valid(stale));
+            assert(short_table.get(h)->value_ == i);
+        }
+        short_table.release(h);
+        for (auto o : others)
+        {
+            short_table.release(o);
+        }
+        assert(alive == 0);
+    }
+
+    // Live chains are freed with the table.
+    {
+        table_t other;
+        other.emplace(5);
+        other.emplace(6);
+        assert(alive == 2);
+    }
+    assert(alive == 0);
+}
+
+void tests::mem_sync_ptr_table_threads(void)
+{
+    static std::atomic<int> alive(0);
+    struct Obj
+    {
+        Obj(void) { ++alive; }
+        ~Obj(void) { --alive; }
+    };
+    typedef mem::sync_table<Obj> table_t;
+
+    table_t table;
+    auto shared = table.emplace();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&table, shared]()
+        {
+            std::vector<table_t::handle_type> own;
+            for (int i = 0; i < 3000; ++i)
+            {
+                own.push_back(table.emplace());
+                table.retain(shared);
+                assert(table.get(shared));
+                if (i % 3 == 0)
+                {
+                    table.release(own.back());
+                    own.pop_back();
+                }
+            }
+            for (int i = 0; i < 3000; ++i)
+            {
+                table.release(shared);
+            }
+            for (auto h : own)
+            {
+                table.release(h);
+            }
+        });
+    }
+    for (auto & t : threads)
+    {
+        t.join();
+    }
+    assert(table.count(shared) == 1U);
+    assert(table.size() == 1U);
+    table.release(shared);
+    assert(alive == 0);
+}
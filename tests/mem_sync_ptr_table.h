@@ -0,0 +1,26 @@
+
+#ifndef __TESTS_MEM_SYNC_PTR_TABLE_H__
+#define __TESTS_MEM_SYNC_PTR_TABLE_H__
+
+#ifndef __MEMORY_SYNC_PTR_TABLE_H__
+#include "mem/sync_ptr_table.h"
+#endif
+
+
+namespace tests
+{
+    /**
+    * \brief Test table chains counting, resets and stale handles.
+    * \note Result: Handles are 32 bits, the last release frees pointee and slot, reused slots reject old handles.
+    */
+    void mem_sync_ptr_table_handles(void);
+
+    /**
+    * \brief Test table chains created, copied and released by concurrent threads.
+    * \note Result: The table grows by chunks, every pointee is freed once.
+    */
+    void mem_sync_ptr_table_threads(void);
+
+} // namespace tests
+
+#endif // __TESTS_MEM_SYNC_PTR_TABLE_H__
@@ -0,0 +1,101 @@
+
+// Main header.
+#include "mem_sync_ptr_wait.h"
+
+#include "cc/sync_ptr.h"
+#include "mem/sync_ptr.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <thread>
+
+
+namespace
+{
+    /**
+    * \brief Consumer waits for each of p_updates changes and checks the published value.
+    */
+    template<
+        class TSyncPtr,
+        class TReset>
+    void produce_consume(
+        TSyncPtr & p_ptr,
+        int p_updates,
+        TReset p_reset)
+    {
+        std::atomic<int> consumed(0);
+        std::thread consumer([&]
+        {
+            auto v = p_ptr.version();
+            int last = *p_ptr;
+            while (last < p_updates)
+            {
+                v = mem::wait_for_change(p_ptr, v);
+                int value = *p_ptr;
+                assert(value > last);
+                last = value;
+                consumed.store(last);
+            }
+        });
+
+        for (int i = 1; i <= p_updates; ++i)
+        {
+            // Let the consumer sleep before some of the updates.
+            if (i % 8 == 0)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            p_reset(p_ptr, i);
+        }
+        consumer.join();
+        assert(consumed.load() == p_updates);
+    }
+
+} // namespace
+
+
+void tests::mem_sync_ptr_wait_change(void)
+{
+    static int values[65];
+    for (int i = 0; i <= 64; ++i)
+    {
+        values[i] = i;
+    }
+
+    {
+        mem::sync_ptr<int, mem::noop_deleter> ptr(&values[0]);
+        produce_consume(ptr, 64, [](mem::sync_ptr<int, mem::noop_deleter> & p_ptr, int p_i)
+        {
+            p_ptr.reset(&values[p_i]);
+        });
+
+        // Timed wait gives up unchanged.
+        auto v = ptr.version();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(5);
+        assert(mem::wait_for_change_until(ptr, v, deadline) == v);
+        assert(std::chrono::steady_clock::now() >= deadline);
+
+        // Notify wakes without retargeting.
+        std::thread notifier([&ptr]
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            ptr.notify();
+        });
+        assert(mem::wait_for_change(ptr, v) != v);
+        assert(ptr.get() == &values[64]);
+        notifier.join();
+    }
+    {
+        cc::sync_ptr<int, mem::noop_deleter> ptr(&values[0]);
+        produce_consume(ptr, 64, [](cc::sync_ptr<int, mem::noop_deleter> & p_ptr, int p_i)
+        {
+            bool ret = p_ptr.reset(&values[p_i]);
+            assert(ret);
+        });
+
+        auto v = ptr.version();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(5);
+        assert(mem::wait_for_change_until(ptr, v, deadline) == v);
+    }
+}
@@ -0,0 +1,20 @@
+
+#ifndef __TESTS_MEM_SYNC_PTR_WAIT_H__
+#define __TESTS_MEM_SYNC_PTR_WAIT_H__
+
+#ifndef __MEMORY_SYNC_PTR_WAIT_H__
+#include "mem/sync_ptr_wait.h"
+#endif
+
+
+namespace tests
+{
+    /**
+    * \brief Test consumers blocked on chains of both flavors until a producer resets them.
+    * \note Result: Waiters wake on reset and notify, timed waits return the unchanged version on timeout.
+    */
+    void mem_sync_ptr_wait_change(void);
+
+} // namespace tests
+
+#endif // __TESTS_MEM_SYNC_PTR_WAIT_H__